@@ -47,8 +47,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <functional>
 #include <type_traits>
 #include <chrono>
+#include <atomic>
+
+#include <sys/stat.h>
 
-#include "candy/utils/Memory.h"
 #include "candy/utils/Options.h"
 
 #include "candy/utils/StreamBuffer.h"
@@ -59,12 +61,15 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "candy/utils/CandyBuilder.h"
 #include "candy/utils/Runtime.h"
+#include "candy/utils/ResultCache.h"
+#include "candy/utils/ResultWriter.h"
 
 using namespace Candy;
 
 static std::vector<CandySolverInterface*> solvers;
 
 static bool interrupted = false;
+static std::atomic<bool> parse_error { false };
 static unsigned int start_time = 0;
 static int interrupted_callback(void* state) {
     if (SolverOptions::time_limit > 0) {
@@ -75,9 +80,6 @@ static int interrupted_callback(void* state) {
             interrupted = true;
         }
     }
-    if (SolverOptions::memory_limit > 0 && static_cast<int>(getCurrentRSS()/(1024*1024)) > SolverOptions::memory_limit) {
-        interrupted = true;
-    }
     return interrupted ? 1 : 0;
 }
 
@@ -109,6 +111,83 @@ static void installSignalHandlers(bool handleInterruptsBySolver) {
 #endif
 }
 
+// modification time in nanoseconds (seconds if not supported), 0 if file does not exist
+static uint64_t modificationTime(const char* filename) {
+    struct stat file_stat;
+    if (stat(filename, &file_stat) != 0) return 0;
+#if defined(__APPLE__) && defined(__MACH__)
+    return file_stat.st_mtimespec.tv_sec * 1000000000ull + file_stat.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    return file_stat.st_mtime;
+#else
+    return file_stat.st_mtim.tv_sec * 1000000000ull + file_stat.st_mtim.tv_nsec;
+#endif
+}
+
+static bool isNewerThan(const char* filename, const char* other) {
+    uint64_t time = modificationTime(filename);
+    return time > 0 && time > modificationTime(other);
+}
+
+/**
+ * Print status and model (if requested) to the standard output or the model file
+ * */
+static void printResult(lbool status, CandySolverResult* model, unsigned int nVars) {
+    std::cout << std::flush;
+    bool to_file = strlen(SolverOptions::opt_model_file) > 0;
+    ResultWriter writer(stdout);
+    writer.writeStatus(status);
+    if (status == l_True && model != nullptr && SolverOptions::mod && !to_file) {
+        writer.writeModel(*model, nVars);
+    }
+    writer.flush();
+    if (to_file) {
+        ResultWriter file(SolverOptions::opt_model_file);
+        if (file.isOpen()) {
+            file.writeStatus(status);
+            if (status == l_True && model != nullptr) {
+                file.writeModel(*model, nVars);
+            }
+        }
+        if (!file.isOpen() || !file.flush()) {
+            std::cout << "c Could not write model file: " << SolverOptions::opt_model_file << std::endl;
+        }
+    }
+}
+
+/**
+ * Print the result of the problem if it is found in the result cache and return the exit code (0 = not found).
+ * Cached models are verified against the problem, as the fingerprint might collide. 
+ * Cached unsatisfiability can not be verified, so the problem is solved again if a proof is requested.
+ * */
+static int printCachedResult(CNFProblem& problem) {
+    ResultCache cache(SolverOptions::opt_result_cache);
+    std::vector<Lit> literals;
+    std::string proof;
+    lbool status = cache.lookup(problem.fingerprint(), literals, proof);
+    CandySolverResult model;
+    for (Lit lit : literals) {
+        model.setModelValue(lit);
+    }
+    if (status == l_True && !problem.checkResult(model)) {
+        std::cout << "c Ignoring cached model which does not satisfy the problem" << std::endl;
+        return 0;
+    }
+    if (status == l_False && strlen(SolverOptions::opt_certified_file) > 0) {
+        std::cout << "c Ignoring cached unsatisfiability as a proof is requested" << std::endl;
+        return 0;
+    }
+    if (status == l_Undef) {
+        return 0;
+    }
+    std::cout << "c Result cache hit: " << cache.filename(problem.fingerprint()) << std::endl;
+    if (!proof.empty()) {
+        std::cout << "c Proof: " << proof << std::endl;
+    }
+    printResult(status, &model, problem.nVars());
+    return status == l_True ? 10 : 20;
+}
+
 static void printProblemStatistics(CNFProblem& problem) {
     std::cout << "c Variables: " << problem.nVars() << std::endl;
     std::cout << "c Clauses: " << problem.nClauses() << std::endl;
@@ -120,19 +199,23 @@ lbool result = l_Undef;
 static void runSolverThread(lbool& result, CandySolverInterface*& solver, CNFProblem& problem, ClauseAllocator*& global_allocator) {
     CandySolverInterface* solver_;
 
+    try {
+        solver_ = createSolver(problem); // parses the clauses of a streamed problem
+    }
+    catch (ParserException& e) {
+        std::cout << "c Caught Parser Exception: " << std::endl << e.what() << std::endl;
+        parse_error = true;
+        return;
+    }
+
     if (ParallelOptions::opt_static_database) {
         if (global_allocator == nullptr) {
-            solver_ = createSolver(problem);
             global_allocator = solver_->getClauseDatabase().createGlobalClauseAllocator();
         }
         else {
-            solver_ = createSolver(problem); // todo
-            solver_->getClauseDatabase().setGlobalClauseAllocator(global_allocator);
+            solver_->getClauseDatabase().setGlobalClauseAllocator(global_allocator); // todo
         }
     }
-    else {
-        solver_ = createSolver(problem);
-    }
 
     solvers.push_back(solver_);
     solver_->setTermCallback(solver_, interrupted_callback);
@@ -151,8 +234,21 @@ int main(int argc, char** argv) {
 
     CNFProblem problem{};
     try {
-        std::cout << "c Reading file: " << argv[1] << std::endl; 
-        problem.readDimacsFromFile(argv[1]);
+        std::string cache = std::string(argv[1]) + ".bcnf";
+        if (SolverOptions::opt_stream_input) {
+            std::cout << "c Streaming file: " << argv[1] << std::endl; 
+            problem.openDimacsStream(argv[1]);
+        }
+        else if (isNewerThan(cache.c_str(), argv[1]) && problem.readBinary(cache.c_str())) {
+            std::cout << "c Reading cache: " << cache << std::endl; 
+        }
+        else {
+            std::cout << "c Reading file: " << argv[1] << std::endl; 
+            problem.readDimacsFromFile(argv[1], ParallelOptions::opt_parse_threads);
+            if (SolverOptions::opt_cnf_cache && !problem.writeBinary(cache.c_str())) {
+                std::cout << "c Could not write cache: " << cache << std::endl; 
+            }
+        }
     }
     catch (ParserException& e) {
 		std::cout << "c Caught Parser Exception: " << std::endl << e.what() << std::endl;
@@ -172,6 +268,11 @@ int main(int argc, char** argv) {
         printProblemStatistics(problem);
     }
 
+    if (strlen(SolverOptions::opt_result_cache) > 0 && !problem.isStreamed()) {
+        int cached = printCachedResult(problem);
+        if (cached != 0) return cached;
+    }
+
     ClauseAllocator* global_allocator = nullptr;
     std::vector<std::thread> threads;
 
@@ -181,10 +282,25 @@ int main(int argc, char** argv) {
             case 3: case 5: problem.sort(false);
         }
         
-        solver = createSolver(problem);
+        try {
+            solver = createSolver(problem); // parses the clauses of a streamed problem
+        }
+        catch (ParserException& e) {
+            std::cout << "c Caught Parser Exception: " << std::endl << e.what() << std::endl;
+            return 1;
+        }
         solvers.push_back(solver); 
         solver->setTermCallback(solver, interrupted_callback);
 
+        if (strlen(SolverOptions::opt_result_cache) > 0 && problem.isStreamed()) { // fingerprint is known now
+            int cached = printCachedResult(problem);
+            if (cached != 0) return cached;
+        }
+
+        if (SolverOptions::opt_release_problem) {
+            problem.release();
+        }
+
         // for (std::vector<BinaryWatcher>& list : solver->getClauseDatabase().binaries) {
         //     std::cout << "wb " << list.size() << std::endl;
         // }
@@ -230,7 +346,21 @@ int main(int argc, char** argv) {
             do { 
                 // wait till solver is initialized (and wait a bit longer)
                 std::this_thread::sleep_for(std::chrono::milliseconds(ParallelOptions::opt_thread_initialization_delay)); 
-            } while (solvers.size() <= count);
+            } while (solvers.size() <= count && !parse_error);
+
+            int code = parse_error ? 1 : 0;
+            if (code == 0 && count == 0 && strlen(SolverOptions::opt_result_cache) > 0 && problem.isStreamed()) { 
+                code = printCachedResult(problem); // fingerprint is known now
+            }
+            if (code != 0) {
+                interrupted = true;
+                for (std::thread& thread : threads) thread.join();
+                return code;
+            }
+        }
+
+        if (SolverOptions::opt_release_problem) { // all solvers are initialized
+            problem.release();
         }
 
         installSignalHandlers(true);
@@ -240,17 +370,17 @@ int main(int argc, char** argv) {
         installSignalHandlers(false);
     }
 
-    std::cout << (result == l_True ? "s SATISFIABLE" : result == l_False ? "s UNSATISFIABLE" : "s INDETERMINATE") << std::endl;
+    printResult(result, solver != nullptr ? &solver->getCandySolverResult() : nullptr, problem.nVars());
 
     if (solver != nullptr) {
         CandySolverResult& model = solver->getCandySolverResult();
 
-        if (result == l_True && SolverOptions::mod) {
-            std::cout << "v";
-            for (Var v = 0; v < (Var)problem.nVars(); v++) {
-                std::cout << " " << model.value(v);
+        if (strlen(SolverOptions::opt_result_cache) > 0 && result != l_Undef) {
+            ResultCache cache(SolverOptions::opt_result_cache);
+            std::vector<Lit> literals = result == l_True ? model.getModelLiterals() : std::vector<Lit>();
+            if (!cache.store(problem.fingerprint(), result, literals, std::string(SolverOptions::opt_certified_file))) {
+                std::cout << "c Could not write result cache: " << cache.filename(problem.fingerprint()) << std::endl;
             }
-            std::cout << " 0" << std::endl;
         }
 
         if (SolverOptions::verb > 0) {
@@ -258,7 +388,7 @@ int main(int argc, char** argv) {
         }
 
         if (TestingOptions::test_model && result == l_True) {
-            bool satisfied = problem.checkResult(model);
+            bool satisfied = SolverOptions::opt_release_problem ? CNFProblem::checkResult(argv[1], model) : problem.checkResult(model);
             if (satisfied) {
                 std::cout << "c Result verified by model checker" << std::endl;
                 std::cout << "c ********************************" << std::endl;
@@ -273,6 +403,9 @@ int main(int argc, char** argv) {
         else if (TestingOptions::test_proof && result == l_False) {
             std::string file (SolverOptions::opt_certified_file);
             SolverOptions::opt_certified_file = "";
+            if (SolverOptions::opt_release_problem) {
+                problem.readDimacsFromFile(argv[1], ParallelOptions::opt_parse_threads);
+            }
             DRATChecker checker(problem);
             bool proved = checker.check_proof(file.c_str());
             if (proved) {
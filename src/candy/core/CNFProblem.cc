@@ -23,6 +23,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 
 #include <unordered_map>
+#include <thread>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <algorithm>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -34,39 +39,325 @@ namespace Candy {
 
 void CNFProblem::printDIMACS() const {
     printf("p cnf %zu %zu\n", nVars(), nClauses()); 
-    for (Cl* clause : problem) {
-        std::cout << *clause << "0" << std::endl;
+    for (CNFClause clause : *this) {
+        std::cout << clause << "0" << std::endl;
     }
 }
 
-void CNFProblem::readDimacsFromFile(const char* filename) {
-    Cl lits;
+/**
+ * Clauses parsed from a chunk of the input into a chunk-local arena (clause i ends at ends[i]).
+ * As the chunk might start in the middle of a clause, the literals before the first terminating 
+ * zero (head) and after the last one (tail) are completed and normalized while merging the 
+ * chunks in file order.
+ * */
+struct DimacsChunk {
+    Cl head;
+    std::vector<Lit> literals;
+    std::vector<uint64_t> ends;
+    std::vector<uint64_t> dropped; // positions of tautological clauses after the head
+    Cl tail;
+    bool terminated = false;
+    unsigned int variables = 0;
+    uint64_t hash = 0;
+    std::exception_ptr error;
+};
+
+static void parseDimacsChunk(const char* begin, const char* end, DimacsChunk& chunk) {
+    try {
+        std::vector<Lit>& lits = chunk.literals;
+        size_t clause_begin = 0;
+        StreamBuffer in(begin, end);
+        in.skipWhitespace();
+        while (!in.eof()) {
+            if (*in == 'c' || *in == 'p') {
+                in.skipLine();
+            }
+            else {
+                int plit = in.readInteger();
+                if (plit != 0) {
+                    lits.push_back(Lit(abs(plit)-1, plit < 0));
+                }
+                else if (!chunk.terminated) {
+                    chunk.head.swap(lits);
+                    chunk.terminated = true;
+                }
+                else {
+                    if (CNFProblem::normalize(lits, clause_begin, chunk.variables)) {
+                        chunk.ends.push_back(lits.size());
+                        chunk.hash += CNFProblem::fingerprint(lits.data() + clause_begin, lits.data() + lits.size());
+                    } else {
+                        chunk.dropped.push_back(chunk.ends.size() + chunk.dropped.size());
+                        lits.resize(clause_begin);
+                    }
+                    clause_begin = lits.size();
+                }
+            }
+            in.skipWhitespace();
+        }
+        chunk.tail.assign(lits.begin() + clause_begin, lits.end());
+        lits.resize(clause_begin);
+    }
+    catch (...) {
+        chunk.error = std::current_exception();
+    }
+}
+
+unsigned int CNFProblem::readDimacsHeader(StreamBuffer& in) {
+    in.skipString("p cnf");
+    int headerVars = in.readInteger();
+    int headerClauses = in.readInteger();
+    if (headerVars < 0 || headerClauses < 0) {
+        throw ParserException("PARSE ERROR! Expected positive occurence count in header but got " + std::to_string(headerVars) + " vars and " + std::to_string(headerClauses) + " clauses");
+    }
+    if (!isStreamed()) {
+        offsets.reserve(headerClauses + 1);
+    }
+    return headerVars;
+}
+
+void CNFProblem::readDimacsFromFile(const char* filename, unsigned int num_threads) {
+    source.clear();
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
     StreamBuffer in(filename);
     in.skipWhitespace();
     while (!in.eof()) {
         if (*in == 'p') {
-            in.skipString("p cnf");
-            int headerVars = in.readInteger();
-            int headerClauses = in.readInteger();
-            if (headerVars < 0 || headerClauses < 0) {
-                throw ParserException("PARSE ERROR! Expected positive occurence count in header but got " + std::to_string(headerVars) + " vars and " + std::to_string(headerClauses) + " clauses");
-            }
-            problem.reserve(headerClauses);
+            readDimacsHeader(in);
         }
         else if (*in == 'c') {
             in.skipLine();
         }
+        else if (num_threads > 1) {
+            readDimacsParallel(in, num_threads);
+            return;
+        }
+        else {
+            size_t clause_begin = literals.size();
+            for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
+                literals.push_back(Lit(abs(plit)-1, plit < 0));
+            }
+            if (normalize(literals, clause_begin, variables)) {
+                hash += fingerprint(literals.data() + clause_begin, literals.data() + literals.size());
+                offsets.push_back(literals.size());
+            } else {
+                dropped.push_back(nClauses() + dropped.size());
+                literals.resize(clause_begin);
+            }
+        }
+        in.skipWhitespace();
+    }
+}
+
+void CNFProblem::openDimacsStream(const char* filename) {
+    clear();
+    source = filename;
+    StreamBuffer in(filename);
+    in.skipWhitespace();
+    while (!in.eof() && *in == 'c') {
+        in.skipLine();
+    }
+    if (!in.eof() && *in == 'p') {
+        variables = std::max(variables, readDimacsHeader(in));
+    }
+}
+
+void CNFProblem::streamClauses(std::function<void(Lit* begin, Lit* end)> sink) {
+    hash = 0;
+    dropped.clear();
+    streamDimacs(source.c_str(), variables, [this, &sink](Lit* begin, Lit* end) {
+        hash += fingerprint(begin, end);
+        sink(begin, end);
+    }, &dropped);
+}
+
+void CNFProblem::streamDimacs(const char* filename, unsigned int& variables, std::function<void(Lit* begin, Lit* end)> sink, std::vector<uint64_t>* dropped) {
+    uint64_t position = 0;
+    std::vector<Lit> lits;
+    StreamBuffer in(filename);
+    in.skipWhitespace();
+    while (!in.eof()) {
+        if (*in == 'p' || *in == 'c') {
+            in.skipLine();
+        }
         else {
             lits.clear();
             for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
                 lits.push_back(Lit(abs(plit)-1, plit < 0));
             }
-            readClause(lits.begin(), lits.end());
+            if (normalize(lits, 0, variables)) {
+                sink(lits.data(), lits.data() + lits.size());
+            }
+            else if (dropped != nullptr) {
+                dropped->push_back(position);
+            }
+            position++;
         }
         in.skipWhitespace();
     }
 }
 
+/**
+ * Parse the remaining input in chunks using up to num_threads workers. 
+ * Mapped input is split in place, otherwise the input is decompressed in batches of blocks.
+ * */
+void CNFProblem::readDimacsParallel(StreamBuffer& in, unsigned int num_threads) {
+    const size_t min_chunk_size = 1 << 20;
+    const size_t block_size = 1 << 22;
+
+    Cl pending;
+    std::vector<DimacsChunk> chunks;
+    std::vector<std::vector<char>> blocks(in.isMapped() ? 0 : num_threads);
+    std::vector<std::pair<const char*, const char*>> ranges;
+
+    while (!in.eof()) {
+        ranges.clear();
+        if (in.isMapped()) {
+            const char* begin = in.data();
+            const char* end = begin + in.available();
+            size_t num_chunks = std::min<size_t>(num_threads, in.available() / min_chunk_size + 1);
+            for (size_t i = 1; i <= num_chunks; i++) {
+                const char* split = i < num_chunks ? std::find(begin + in.available() * i / num_chunks, end, '\n') : end;
+                const char* last = ranges.empty() ? begin : ranges.back().second;
+                if (split < end) split++;
+                if (split > last) ranges.emplace_back(last, split);
+            }
+            in.incPos(in.available());
+        }
+        else {
+            for (std::vector<char>& block : blocks) {
+                if (!in.readBlock(block, block_size)) break;
+                ranges.emplace_back(block.data(), block.data() + block.size());
+            }
+        }
+
+        chunks.clear();
+        chunks.resize(ranges.size());
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < ranges.size(); i++) {
+            workers.emplace_back(parseDimacsChunk, ranges[i].first, ranges[i].second, std::ref(chunks[i]));
+        }
+        if (!ranges.empty()) {
+            parseDimacsChunk(ranges[0].first, ranges[0].second, chunks[0]);
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        for (DimacsChunk& chunk : chunks) {
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
+            }
+        }
+
+        for (DimacsChunk& chunk : chunks) {
+            if (chunk.terminated) {
+                pending.insert(pending.end(), chunk.head.begin(), chunk.head.end());
+                readClause(pending.begin(), pending.end());
+                pending.swap(chunk.tail);
+                uint64_t base = literals.size();
+                uint64_t first = nClauses() + dropped.size(); // input position of the first clause after the head
+                for (uint64_t position : chunk.dropped) {
+                    dropped.push_back(first + position);
+                }
+                literals.insert(literals.end(), chunk.literals.begin(), chunk.literals.end());
+                for (uint64_t end : chunk.ends) {
+                    offsets.push_back(base + end);
+                }
+                hash += chunk.hash;
+                variables = std::max(variables, chunk.variables);
+            }
+            else {
+                pending.insert(pending.end(), chunk.tail.begin(), chunk.tail.end());
+            }
+        }
+    }
+
+    if (!pending.empty()) { // last clause is not terminated by zero
+        readClause(pending.begin(), pending.end());
+    }
+}
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t variables;
+    uint64_t clauses;
+    uint64_t literals;
+    uint64_t dropped;
+};
+
+static const char binary_magic[8] = { 'C', 'A', 'N', 'D', 'Y', 'C', 'N', 'F' };
+static const uint32_t binary_version = 2; // also detects foreign byte order
+
+bool CNFProblem::writeBinary(const char* filename) const {
+    std::ofstream out(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    BinaryHeader header;
+    std::copy(binary_magic, binary_magic + sizeof(binary_magic), header.magic);
+    header.version = binary_version;
+    header.variables = variables;
+    header.clauses = nClauses();
+    header.literals = literals.size();
+    header.dropped = dropped.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(literals.data()), literals.size() * sizeof(Lit));
+    out.write(reinterpret_cast<const char*>(dropped.data()), dropped.size() * sizeof(uint64_t));
+    out.close();
+    return !out.fail();
+}
+
+bool CNFProblem::readBinary(const char* filename) {
+    static_assert(sizeof(Lit) == sizeof(int32_t), "Binary format stores 32-bit literals");
+    clear();
+    variables = 0;
+
+    std::ifstream in(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    uint64_t size = in.tellg();
+    in.seekg(0);
+
+    BinaryHeader header;
+    if (size < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    if (!std::equal(binary_magic, binary_magic + sizeof(binary_magic), header.magic) || header.version != binary_version) {
+        return false;
+    }
+    // bound each count by the payload before multiplying, so a crafted header cannot overflow the size check
+    uint64_t payload = size - sizeof(header);
+    if (header.clauses >= payload / sizeof(uint64_t) || header.literals > payload / sizeof(Lit) || header.dropped > payload / sizeof(uint64_t)
+        || payload != (header.clauses + 1 + header.dropped) * sizeof(uint64_t) + header.literals * sizeof(Lit)) {
+        return false;
+    }
+
+    offsets.resize(header.clauses + 1);
+    literals.resize(header.literals);
+    dropped.resize(header.dropped);
+    in.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    in.read(reinterpret_cast<char*>(literals.data()), literals.size() * sizeof(Lit));
+    in.read(reinterpret_cast<char*>(dropped.data()), dropped.size() * sizeof(uint64_t));
+    bool valid = in && offsets.front() == 0 && offsets.back() == header.literals 
+        && std::is_sorted(offsets.begin(), offsets.end())
+        && std::adjacent_find(dropped.begin(), dropped.end(), std::greater_equal<uint64_t>()) == dropped.end()
+        && std::all_of(literals.begin(), literals.end(), [&header](Lit lit) { return lit.x >= 0 && (uint32_t)lit.var() < header.variables; });
+    if (!valid) {
+        clear();
+        return false;
+    }
+    variables = header.variables;
+    for (CNFClause clause : *this) {
+        hash += fingerprint(clause.begin(), clause.end());
+    }
+    return true;
+}
+
 void CNFProblem::readClause(std::initializer_list<Lit> list) {
     readClause(list.begin(), list.end());
 }
@@ -82,43 +373,55 @@ void CNFProblem::readClauses(std::initializer_list<std::initializer_list<Lit>> f
 }
 
 void CNFProblem::readClauses(For& f) {
+    offsets.reserve(offsets.size() + f.size());
     for (Cl* c : f) {
         readClause(c->begin(), c->end());
     }
 }
 
-template <typename Iterator>
-void CNFProblem::readClause(Iterator begin, Iterator end) {
-    Cl* clause = new Cl(begin, end);
-    if (clause->size() > 0) {
-        std::sort(clause->begin(), clause->end());
+bool CNFProblem::normalize(std::vector<Lit>& arena, size_t begin, unsigned int& variables) {
+    if (arena.size() > begin) {
+        std::vector<Lit>::iterator clause = arena.begin() + begin;
+        std::sort(clause, arena.end());
         // record maximal variable
-        variables = std::max(variables, (unsigned int)clause->back().var()+1); 
+        variables = std::max(variables, (unsigned int)arena.back().var()+1); 
         // remove redundant literals
-        clause->erase(std::unique(clause->begin(), clause->end()), clause->end());
-        // skip tatological clause
-        bool isTautological = clause->end() != std::unique(clause->begin(), clause->end(), [](Lit l1, Lit l2) { return l1.var() == l2.var(); });
-        if (isTautological) {
-            delete clause;
-            return;
-        }
+        arena.erase(std::unique(clause, arena.end()), arena.end());
+        // detect tatological clause
+        return arena.end() == std::adjacent_find(clause, arena.end(), [](Lit l1, Lit l2) { return l1.var() == l2.var(); });
     }
-    problem.push_back(clause);
+    return true;
+}
+
+template <typename Iterator>
+void CNFProblem::readClause(Iterator begin, Iterator end) {
+    size_t clause_begin = literals.size();
+    literals.insert(literals.end(), begin, end);
+    if (!normalize(literals, clause_begin, variables)) {
+        dropped.push_back(nClauses() + dropped.size());
+        literals.resize(clause_begin);
+        return;
+    }
+    hash += fingerprint(literals.data() + clause_begin, literals.data() + literals.size());
+    offsets.push_back(literals.size());
 }
 
 bool CNFProblem::checkResult(CandySolverResult& result) {
-    for (Cl* clause : problem) {
+    if (isStreamed()) {
+        return checkResult(source.c_str(), result);
+    }
+    for (CNFClause clause : *this) {
         bool satisfied = false;
-        for (Lit lit : *clause) {
+        for (Lit lit : clause) {
             if (result.satisfies(lit)) {
                 satisfied = true; 
                 break;
             }
         }
         if (!satisfied) {
-            std::cout << "c Clause not satisfied: " << *clause << std::endl;
+            std::cout << "c Clause not satisfied: " << clause << std::endl;
             std::cout << "c Values: ";
-            for (Lit lit : *clause) {
+            for (Lit lit : clause) {
                 std::cout << "c (" << lit.var() << ", " << result.value(lit.var()) << ")" << std::endl;
             }
             return false;
@@ -127,6 +430,18 @@ bool CNFProblem::checkResult(CandySolverResult& result) {
     return true;
 }
 
+bool CNFProblem::checkResult(const char* filename, CandySolverResult& result) {
+    unsigned int vars = 0;
+    bool satisfied = true;
+    streamDimacs(filename, vars, [&result, &satisfied](Lit* begin, Lit* end) {
+        if (satisfied && std::none_of(begin, end, [&result](Lit lit) { return result.satisfies(lit); })) {
+            std::cout << "c Clause not satisfied: " << Cl(begin, end) << std::endl;
+            satisfied = false;
+        }
+    });
+    return satisfied;
+}
+
 /**
  * Use with care: renames all variables for as gap-less representation.
  * Translate back if you care about semantics.
@@ -135,13 +450,15 @@ void CNFProblem::normalizeVariableNames() {
     std::unordered_map<Var, Var> name;
     //name.resize(variables, -1);
     unsigned int max = 0;
-    for (Cl* clause : problem) {
-        for (Lit& lit : *clause) {
-            if (name[lit.var()] == -1) name[lit.var()] = max++;
-            lit = Lit(name[lit.var()], lit.sign());
-        }
+    for (Lit& lit : literals) {
+        if (name[lit.var()] == -1) name[lit.var()] = max++;
+        lit = Lit(name[lit.var()], lit.sign());
     }
     variables = max;
+    hash = 0;
+    for (CNFClause clause : *this) {
+        hash += fingerprint(clause.begin(), clause.end());
+    }
 }
 
 }
@@ -23,50 +23,212 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 
 #include <math.h>
+#include <iterator>
+#include <string>
 
 typedef struct gzFile_s *gzFile;
 
+class StreamBuffer;
+
 namespace Candy {
 
 class CandySolverResult;
 
+/**
+ * View of a clause stored in the literal arena of CNFProblem, 
+ * read-only for L = const Lit (CNFClause) and writable for L = Lit (CNFClauseRef).
+ * Views are invalidated when clauses are added to the problem.
+ * */
+template<typename L>
+class CNFClauseView {
+    L* literals;
+    uint32_t length;
+
+public:
+    CNFClauseView(L* literals_, uint32_t length_) : literals(literals_), length(length_) { }
+
+    typedef L* iterator;
+    typedef const Lit* const_iterator;
+
+    inline L* begin() const {
+        return literals;
+    }
+
+    inline L* end() const {
+        return literals + length;
+    }
+
+    inline uint32_t size() const {
+        return length;
+    }
+
+    inline Lit operator [](uint32_t i) const {
+        return literals[i];
+    }
+
+    inline Lit back() const {
+        return literals[length-1];
+    }
+
+    template<typename M>
+    inline bool operator ==(const CNFClauseView<M>& other) const {
+        return length == other.size() && std::equal(begin(), end(), other.begin());
+    }
+
+    template<typename M>
+    inline bool operator !=(const CNFClauseView<M>& other) const {
+        return !(*this == other);
+    }
+};
+
+typedef CNFClauseView<const Lit> CNFClause;
+typedef CNFClauseView<Lit> CNFClauseRef;
+
+template<typename L>
+inline std::ostream& operator <<(std::ostream& stream, CNFClauseView<L> const& clause) {
+    for (Lit lit : clause) {
+        stream << lit << " ";
+    }
+    return stream;
+}
+
+/**
+ * The clauses are stored consecutively in one literal arena, 
+ * clause i occupies the literals in [offsets[i], offsets[i+1]).
+ * */
 class CNFProblem {
 
 private:
-    For problem;
+    std::vector<Lit> literals;
+    std::vector<uint64_t> offsets;
     unsigned int variables;
+    uint64_t hash; // order-independent fingerprint of the clauses
+    std::string source; // file with the clauses of a streamed problem
+    std::vector<uint64_t> dropped; // input positions of tautological clauses
 
 public:
-    CNFProblem() : variables(0) { }
+    CNFProblem() : offsets(1, 0), variables(0), hash(0), source(), dropped() { }
 
-    CNFProblem(For& formula) : variables(0) {
+    CNFProblem(For& formula) : CNFProblem() {
         readClauses(formula);
     }
 
-    CNFProblem(Cl& clause) : variables(0) {
+    CNFProblem(Cl& clause) : CNFProblem() {
         readClause(clause.begin(), clause.end());
     }
 
-    CNFProblem(std::initializer_list<std::initializer_list<Lit>> formula) : variables(0) {
+    CNFProblem(std::initializer_list<std::initializer_list<Lit>> formula) : CNFProblem() {
         readClauses(formula);
     }
 
-    ~CNFProblem() {
-        clear();
-    }
+    class const_iterator {
+        const CNFProblem* problem;
+        size_t index;
 
-    typedef For::const_iterator const_iterator;
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef CNFClause value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const CNFClause* pointer;
+        typedef CNFClause reference;
+
+        const_iterator(const CNFProblem* problem_, size_t index_) : problem(problem_), index(index_) { }
+
+        inline CNFClause operator *() const {
+            return (*problem)[index];
+        }
+
+        inline const_iterator& operator ++() {
+            ++index;
+            return *this;
+        }
+
+        inline const_iterator operator ++(int) {
+            const_iterator copy = *this;
+            ++index;
+            return copy;
+        }
+
+        inline const_iterator& operator --() {
+            --index;
+            return *this;
+        }
+
+        inline const_iterator operator --(int) {
+            const_iterator copy = *this;
+            --index;
+            return copy;
+        }
+
+        inline const_iterator& operator +=(difference_type n) {
+            index += n;
+            return *this;
+        }
+
+        inline const_iterator& operator -=(difference_type n) {
+            index -= n;
+            return *this;
+        }
+
+        inline const_iterator operator +(difference_type n) const {
+            return const_iterator(problem, index + n);
+        }
+
+        inline const_iterator operator -(difference_type n) const {
+            return const_iterator(problem, index - n);
+        }
+
+        inline difference_type operator -(const const_iterator& other) const {
+            return index - other.index;
+        }
+
+        inline CNFClause operator [](difference_type n) const {
+            return (*problem)[index + n];
+        }
+
+        inline bool operator ==(const const_iterator& other) const {
+            return index == other.index;
+        }
+
+        inline bool operator !=(const const_iterator& other) const {
+            return index != other.index;
+        }
+
+        inline bool operator <(const const_iterator& other) const {
+            return index < other.index;
+        }
+
+        inline bool operator >(const const_iterator& other) const {
+            return index > other.index;
+        }
+
+        inline bool operator <=(const const_iterator& other) const {
+            return index <= other.index;
+        }
+
+        inline bool operator >=(const const_iterator& other) const {
+            return index >= other.index;
+        }
+
+        friend inline const_iterator operator +(difference_type n, const const_iterator& it) {
+            return it + n;
+        }
+    };
 
     inline const_iterator begin() const {
-        return problem.begin();
+        return const_iterator(this, 0);
     }
 
     inline const_iterator end() const {
-        return problem.end();
+        return const_iterator(this, nClauses());
+    }
+
+    inline CNFClause operator [](size_t i) const {
+        return CNFClause(literals.data() + offsets[i], offsets[i+1] - offsets[i]);
     }
 
-    inline const Cl* operator [](int i) const {
-        return problem[i];
+    inline CNFClauseRef operator [](size_t i) {
+        return CNFClauseRef(literals.data() + offsets[i], offsets[i+1] - offsets[i]);
     }
 
     inline size_t nVars() const {
@@ -74,7 +236,11 @@ public:
     }
 
     inline size_t nClauses() const {
-        return problem.size();
+        return offsets.size() - 1;
+    }
+
+    inline size_t nLiterals() const {
+        return literals.size();
     }
 
     inline int newVar() {
@@ -82,54 +248,130 @@ public:
     }
 
     inline void clear() {
-        for (Cl* clause : problem) {
-            delete clause;
+        literals.clear();
+        offsets.assign(1, 0);
+        hash = 0;
+        source.clear();
+        dropped.clear();
+    }
+
+    /**
+     * Positions (0-based, in input order) of the tautological clauses which were dropped while reading, 
+     * such that clause i of the problem is input clause i plus the number of dropped clauses before it. 
+     * Proofs in LRAT format refer to the input clauses by their position. 
+     * */
+    inline const std::vector<uint64_t>& droppedClauses() const {
+        return dropped;
+    }
+
+    /**
+     * Fingerprint of the normalized clauses which is independent of the order of clauses and literals.
+     * It is computed while reading (for streamed problems while streaming the clauses).
+     * */
+    inline uint64_t fingerprint() const {
+        return hash;
+    }
+
+    static inline uint64_t fingerprint(const Lit* begin, const Lit* end) {
+        uint64_t sum = end - begin;
+        for (const Lit* lit = begin; lit != end; lit++) {
+            sum += mix(lit->x + 1);
         }
-        problem.clear();
+        return mix(sum);
+    }
+
+    /**
+     * Free the memory held by the clauses but keep the number of variables.
+     * */
+    inline void release() {
+        std::vector<Lit>().swap(literals);
+        std::vector<uint64_t>(1, 0).swap(offsets);
     }
 
     void normalizeVariableNames();
     bool checkResult(CandySolverResult& result);
 
+    /**
+     * Check the model against the clauses in the given DIMACS file, which is streamed 
+     * clause by clause (for use after the problem has been released). 
+     * Streamed problems are checked this way by checkResult(result) as well.
+     * */
+    static bool checkResult(const char* filename, CandySolverResult& result);
+
     void sort(bool asc) {
         std::vector<double> occurrence(2 * variables, 0.0);
-        for (Cl* c : problem) {
-            for (Lit lit : *c) {
-                occurrence[lit] += 1.0 / pow(2, c->size());
+        for (CNFClause c : *this) {
+            for (Lit lit : c) {
+                occurrence[lit] += 1.0 / pow(2, c.size());
             }
         }
         if (asc) {
-            for (Cl* c : problem) {
-                std::sort(c->begin(), c->end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] < occurrence[lit2]; });
+            for (size_t i = 0; i < nClauses(); i++) {
+                CNFClauseRef c = (*this)[i];
+                std::sort(c.begin(), c.end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] < occurrence[lit2]; });
             }
         } else {
-            for (Cl* c : problem) {
-                std::sort(c->begin(), c->end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] > occurrence[lit2]; });
+            for (size_t i = 0; i < nClauses(); i++) {
+                CNFClauseRef c = (*this)[i];
+                std::sort(c.begin(), c.end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] > occurrence[lit2]; });
             }
         }
     }
 
     void sort2(bool asc) {
         std::vector<double> occurrence(2 * variables, 0.0);
-        for (Cl* c : problem) {
-            for (Lit lit : *c) {
-                occurrence[lit] += 1.0 / pow(2, c->size());
+        for (CNFClause c : *this) {
+            for (Lit lit : c) {
+                occurrence[lit] += 1.0 / pow(2, c.size());
             }
         }
         if (asc) {
-            for (Cl* c : problem) {
-                std::sort(c->begin(), c->end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] - occurrence[~lit1] < occurrence[lit2] - occurrence[~lit2]; });
+            for (size_t i = 0; i < nClauses(); i++) {
+                CNFClauseRef c = (*this)[i];
+                std::sort(c.begin(), c.end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] - occurrence[~lit1] < occurrence[lit2] - occurrence[~lit2]; });
             }
         } else {
-            for (Cl* c : problem) {
-                std::sort(c->begin(), c->end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] - occurrence[~lit1] > occurrence[lit2] - occurrence[~lit2]; });
+            for (size_t i = 0; i < nClauses(); i++) {
+                CNFClauseRef c = (*this)[i];
+                std::sort(c.begin(), c.end(), [&occurrence](Lit lit1, Lit lit2) { return occurrence[lit1] - occurrence[~lit1] > occurrence[lit2] - occurrence[~lit2]; });
             }
         }
     }
 
     void printDIMACS() const;
 
-    void readDimacsFromFile(const char* filename);
+    /**
+     * Read DIMACS from (possibly compressed) file. With num_threads > 1 the input 
+     * is split at line boundaries and the chunks are parsed and normalized concurrently 
+     * (num_threads = 0 uses all cores). The clauses are stored in file order.
+     * */
+    void readDimacsFromFile(const char* filename, unsigned int num_threads = 1);
+
+    /**
+     * Binary serialization of the (normalized) formula: a header with the number of variables,
+     * clauses, literals and dropped clauses, followed by the clause offsets (64 bits), the literals (32 bits)
+     * and the positions of the dropped clauses (64 bits).
+     * readBinary() returns false and leaves the problem empty if the file is not a valid cache.
+     * */
+    bool writeBinary(const char* filename) const;
+    bool readBinary(const char* filename);
+
+    /**
+     * Read only the header of the DIMACS file, the clauses are not stored. 
+     * The clause database of a solver built from a streamed problem parses the normalized 
+     * clauses directly from the file (cf. streamClauses), such that the formula is not held twice.
+     * */
+    void openDimacsStream(const char* filename);
+
+    inline bool isStreamed() const {
+        return !source.empty();
+    }
+
+    /**
+     * Pass the normalized clauses of the streamed problem to the sink one by one.
+     * nVars() is raised before a clause with new variables is passed on.
+     * */
+    void streamClauses(std::function<void(Lit* begin, Lit* end)> sink);
 
     void readClause(std::initializer_list<Lit> list);
     void readClause(Cl& cl);
@@ -140,6 +382,26 @@ public:
     template <typename Iterator>
     void readClause(Iterator begin, Iterator end);
 
+    /**
+     * Sort the clause in arena[begin..] and remove duplicate literals (raises 'variables' to cover the clause).
+     * Returns false if the clause is tautological.
+     * */
+    static bool normalize(std::vector<Lit>& arena, size_t begin, unsigned int& variables);
+
+private:
+    unsigned int readDimacsHeader(StreamBuffer& in);
+
+    static inline uint64_t mix(uint64_t x) { // splitmix64 finalizer
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    static void streamDimacs(const char* filename, unsigned int& variables, std::function<void(Lit* begin, Lit* end)> sink, std::vector<uint64_t>* dropped = nullptr);
+    void readDimacsParallel(StreamBuffer& in, unsigned int num_threads);
+
+public:
+
     // CNFProblem can only be moved, not copied
     CNFProblem(const CNFProblem& other) = delete;
     CNFProblem& operator=(const CNFProblem& other) = delete;
@@ -77,6 +77,11 @@ public:
         return (Var)model.size() > lit.var() && l_True == (model[lit.var()] ^ lit.sign());
     }
 
+    // model value of the given variable (l_Undef if not in the model)
+    lbool modelValue(Var x) const {
+        return x < (Var)model.size() ? model[x] : l_Undef;
+    }
+
     // return satisfied literal for given variable
     Lit value(Var x) const {
         if (model[x] == l_False) {
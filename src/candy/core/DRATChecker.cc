@@ -30,17 +30,22 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <sys/stat.h>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 namespace Candy {
 
+const uint32_t DRATChecker::no_clause;
+
 DRATChecker::DRATChecker(CNFProblem& problem)
- : clause_db(problem), trail(problem), propagation(clause_db, trail), occurences(), num_deleted(0) 
+ : clause_db(problem), trail(problem), propagation(clause_db, trail), occurences(), index(), num_deleted(0) 
 { 
     occurences.resize(2 * clause_db.nVars());
+    seen.resize(clause_db.nVars(), 0);
     for (Clause* clause : clause_db) {
         for (Lit lit : *clause) {
             occurences[lit].push_back(clause);
         }
+        index.emplace(hash(clause->begin(), clause->end()), clause);
         if (clause->size() == 1 && !trail.fact(clause->first())) {
             clause_db.emptyClause();
         }
@@ -55,39 +60,841 @@ long DRATChecker::proof_size(const char* filename) {
     return (rc == 0) ? stat_buf.st_size : -1;
 }
 
+/**
+ * Binary proofs start with 'a' or 'd' followed by encoded literals, 
+ * the first bytes of text proofs are digits, whitespace, '-', 'd' or a comment.
+ * */
+static bool is_binary_proof(const char* data, size_t size) {
+    if (size == 0 || data[0] == 'c') {
+        return false;
+    }
+    for (size_t i = 0; i < std::min<size_t>(size, 16); i++) {
+        if (!isdigit(data[i]) && !isspace(data[i]) && data[i] != '-' && data[i] != 'd') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * LRAT lines start with the clause id, followed by 'd' for deletions or by the literals and 
+ * antecedents which are both terminated by 0.
+ * */
+static bool is_lrat_proof(const char* data, size_t size) {
+    const char* end = data + size;
+    while (data < end && (isspace(*data) || *data == 'c')) {
+        if (*data == 'c') data = std::find(data, end, '\n');
+        else data++;
+    }
+    const char* eol = std::find(data, end, '\n');
+    unsigned int tokens = 0, zeros = 0;
+    for (const char* it = data; it < eol; ) {
+        while (it < eol && isspace(*it)) it++;
+        const char* token = it;
+        while (it < eol && !isspace(*it)) it++;
+        if (token == it) break;
+        if (tokens++ == 1 && *token == 'd') return true;
+        if (it - token == 1 && *token == '0') zeros++;
+    }
+    return zeros == 2;
+}
+
+/**
+ * Reads text or binary proofs and passes each line to callback(deletion, literals) 
+ * until the callback returns false. Returns false for malformed binary proofs.
+ * */
+template <typename Callback>
+bool DRATChecker::read_proof(const char* filename, Callback callback) {
+    Cl lits;
+    StreamBuffer in(filename);
+    if (is_binary_proof(in.data(), in.available())) {
+        while (!in.eof()) {
+            int type = *in;
+            ++in;
+            lits.clear();
+            for (uint64_t ulit = in.readVarint(); ulit != 0; ulit = in.readVarint()) {
+                lits.push_back(Lit((ulit >> 1) - 1, ulit & 1));
+            }
+            if (type != 'a' && type != 'd') {
+                return false;
+            }
+            if (!callback(type == 'd', lits)) {
+                break;
+            }
+        }
+        return true;
+    }
+    in.skipWhitespace();
+    while (!in.eof()) {
+        if (*in == 'c') {
+            in.skipLine();
+        }
+        else {
+            bool deletion = *in == 'd';
+            if (deletion) ++in;
+            lits.clear();
+            for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
+                lits.push_back(Lit(abs(plit)-1, plit < 0));
+            }
+            if (!callback(deletion, lits)) {
+                break;
+            }
+        }
+        in.skipWhitespace();
+    }
+    return true;
+}
+
 bool DRATChecker::check_proof(const char* filename) {
-    if (!clause_db.hasEmptyClause()) {
-        Cl lits;
+    if (clause_db.hasEmptyClause()) {
+        return true;
+    }
+    bool lrat;
+    {
         StreamBuffer in(filename);
+        lrat = is_lrat_proof(in.data(), in.available());
+    }
+    if (lrat) {
+        return check_proof_lrat(filename);
+    }
+    if (TestingOptions::test_proof_threads > 1) {
+        return check_proof_parallel(filename, TestingOptions::test_proof_threads);
+    }
+    if (TestingOptions::test_proof_backward) {
+        return check_proof_backward(filename);
+    }
+    return check_proof_forward(filename);
+}
+
+bool DRATChecker::check_proof_forward(const char* filename) {
+    bool failed = false;
+    bool wellformed = read_proof(filename, [this, &failed](bool deletion, Cl& lits) {
+        if (deletion) {
+            check_clause_remove(lits.begin(), lits.end());
+        }
+        else if (!check_clause_add(lits.begin(), lits.end())) {
+            failed = true;
+        }
+        return !failed && !clause_db.hasEmptyClause();
+    });
+    return wellformed && !failed && clause_db.hasEmptyClause();
+}
+
+void DRATChecker::reset_arena() {
+    literals.clear();
+    offsets.assign(1, 0);
+    active.clear();
+    core.clear();
+    units.clear();
+    steps.clear();
+    arena_index.clear();
+    watches.assign(2 * clause_db.nVars(), std::vector<uint32_t>());
+    values.assign(2 * clause_db.nVars(), 0);
+    reasons.assign(clause_db.nVars(), no_clause);
+    positions.assign(clause_db.nVars(), 0);
+    seen.assign(clause_db.nVars(), 0);
+    assigned.clear();
+    core_head = head = 0;
+}
+
+/**
+ * Replay formula and proof without checks until propagation runs into a conflict, 
+ * returns the conflicting clause or no_clause if the proof is malformed or incomplete
+ * */
+uint32_t DRATChecker::replay_proof(const char* filename) {
+    reset_arena();
+
+    uint32_t conflict = no_clause;
+    for (Clause* clause : clause_db) {
+        uint32_t index = store_clause(clause->begin(), clause->end());
+        if (conflict == no_clause) conflict = attach(index);
+    }
+    if (conflict == no_clause) conflict = propagate();
+    if (conflict != no_clause) {
+        return conflict;
+    }
+
+    bool wellformed = read_proof(filename, [this, &conflict](bool deletion, Cl& lits) {
+        if (deletion) {
+            uint32_t clause = remove_clause(lits.begin(), lits.end());
+            if (clause != no_clause) {
+                steps.push_back({ clause, true });
+            }
+        }
+        else {
+            uint32_t clause = store_clause(lits.begin(), lits.end());
+            steps.push_back({ clause, false });
+            conflict = clause_size(clause) == 0 ? clause : attach(clause);
+            if (conflict == no_clause) conflict = propagate();
+        }
+        return conflict == no_clause;
+    });
+    return wellformed ? conflict : no_clause;
+}
+
+bool DRATChecker::check_proof_backward(const char* filename) {
+    uint32_t conflict = replay_proof(filename);
+    if (conflict == no_clause) {
+        return false;
+    }
+    analyze(conflict);
+
+    // remove lemmas in reverse order and check those which are marked
+    backtrack(0);
+    bool dirty = true;
+    for (size_t i = steps.size(); i-- > 0; ) {
+        uint32_t clause = steps[i].clause;
+        if (steps[i].deletion) {
+            active[clause] = true;
+            if (attach(clause) == no_clause) propagate();
+        }
+        else {
+            active[clause] = false;
+            detach(clause);
+            if (dirty) {
+                restart(0);
+                dirty = false;
+            }
+            else if (is_reason(clause)) {
+                Lit implied = clause_size(clause) > 0 ? *clause_begin(clause) : lit_Undef;
+                restart(positions[implied.var()]);
+            }
+            if (core[clause] && !check_lemma(clause)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Check LRAT proofs: the original clauses have the ids of their positions in the input, 
+ * each lemma has to be implied by unit propagation of its hints in the given order, 
+ * i.e. the hint chain has to end in a conflict. 
+ * */
+bool DRATChecker::check_proof_lrat(const char* filename) {
+    reset_arena();
+    ids.assign(1, no_clause);
+    for (Clause* clause : clause_db) {
+        if (ids.size() <= clause->id()) ids.resize(clause->id() + 1, no_clause);
+        ids[clause->id()] = store_clause(clause->begin(), clause->end());
+    }
+
+    bool proved = false;
+    Cl lits;
+    std::vector<int> hints;
+    StreamBuffer in(filename);
+    in.skipWhitespace();
+    while (!in.eof() && !proved) {
+        if (*in == 'c') {
+            in.skipLine();
+            continue;
+        }
+        int id = in.readInteger();
         in.skipWhitespace();
-        while (!in.eof() && !clause_db.hasEmptyClause()) {
-            if (*in == 'c') {
-                in.skipLine();
-            }
-            else if (*in == 'd') {
-                ++in;
-                lits.clear();
-                for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
-                    lits.push_back(Lit(abs(plit)-1, plit < 0));
+        if (id < 0 || in.eof()) {
+            return false;
+        }
+        if (*in == 'd') {
+            ++in;
+            for (int other = in.readInteger(); other != 0; other = in.readInteger()) {
+                uint32_t clause = clause_by_id(other);
+                if (clause != no_clause) {
+                    active[clause] = false;
+                }
+            }
+        }
+        else {
+            lits.clear();
+            for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
+                lits.push_back(Lit(abs(plit)-1, plit < 0));
+            }
+            hints.clear();
+            for (int hint = in.readInteger(); hint != 0; hint = in.readInteger()) {
+                hints.push_back(hint);
+            }
+            uint32_t lemma = store_clause(lits.begin(), lits.end());
+            active[lemma] = false;
+            if (!check_hints(lemma, hints)) {
+                return false;
+            }
+            active[lemma] = true;
+            if (ids.size() <= (size_t)id) ids.resize(id + 1, no_clause);
+            ids[id] = lemma;
+            if (lits.empty()) {
+                proved = true;
+            }
+        }
+        in.skipWhitespace();
+    }
+    return proved;
+}
+
+uint32_t DRATChecker::clause_by_id(int id) {
+    if (id <= 0 || (size_t)id >= ids.size() || ids[id] == no_clause || !active[ids[id]]) {
+        return no_clause;
+    }
+    return ids[id];
+}
+
+/**
+ * Check if the negation of the lemma and the hints propagate to a conflict in the given order
+ * */
+bool DRATChecker::check_hints(uint32_t lemma, const std::vector<int>& hints) {
+    size_t level = assigned.size();
+    bool conflict = false;
+    for (Lit* it = clause_begin(lemma); it != clause_end(lemma); it++) {
+        if (value(*it) == 1) {
+            conflict = true;
+            break;
+        }
+        else if (value(*it) == 0) {
+            assign(~*it, no_clause);
+        }
+    }
+    for (auto hint = hints.begin(); !conflict && hint != hints.end(); hint++) {
+        uint32_t clause = clause_by_id(*hint);
+        if (clause == no_clause) break; // unknown, deleted or RAT hint (not supported)
+        Lit unit = lit_Undef;
+        size_t unassigned = 0;
+        for (Lit* it = clause_begin(clause); it != clause_end(clause); it++) {
+            if (value(*it) == 1) {
+                unit = *it; // satisfied, e.g. by a top-level assignment
+                break;
+            }
+            else if (value(*it) == 0) {
+                unit = *it;
+                unassigned++;
+            }
+        }
+        if (unassigned == 0 && unit == lit_Undef) {
+            conflict = true;
+        }
+        else if (unassigned == 1 && value(unit) == 0) {
+            assign(unit, clause);
+        }
+        else if (value(unit) != 1) {
+            break;
+        }
+    }
+    backtrack(level);
+    return conflict;
+}
+
+/**
+ * Verifies the lemmas of a slice of the proof steps. The worker starts from the clauses which are 
+ * active before its first step (the deletion snapshot) and then adds and removes clauses in proof order. 
+ * Clauses are watched by copies of their watched literals, such that the shared arena stays read-only.
+ * */
+class DRATChecker::Worker {
+    const DRATChecker& checker;
+    size_t first_step, last_step;
+
+    std::vector<char> active; // by clause
+    std::vector<Lit> watched; // two watched literals per clause
+    std::vector<std::vector<uint32_t>> watches; // clauses watching the literal
+    std::vector<signed char> values; // by literal: 1 true, -1 false
+    std::vector<uint32_t> reasons; // by variable
+    std::vector<Lit> assigned;
+    size_t head;
+    bool refuted; // top-level propagation ran into a conflict
+
+    inline const Lit* begin(uint32_t clause) const {
+        return checker.literals.data() + checker.offsets[clause];
+    }
+
+    inline const Lit* end(uint32_t clause) const {
+        return checker.literals.data() + checker.offsets[clause+1];
+    }
+
+    void assign(Lit lit, uint32_t reason) {
+        values[lit] = 1;
+        values[~lit] = -1;
+        reasons[lit.var()] = reason;
+        assigned.push_back(lit);
+    }
+
+    void backtrack(size_t position) {
+        for (size_t i = position; i < assigned.size(); i++) {
+            values[assigned[i]] = 0;
+            values[~assigned[i]] = 0;
+            reasons[assigned[i].var()] = no_clause;
+        }
+        assigned.resize(std::min(position, assigned.size()));
+        head = std::min(head, position);
+    }
+
+    bool is_reason(uint32_t clause) const {
+        Lit implied = watched[2*clause];
+        return begin(clause) != end(clause) && reasons[implied.var()] == clause && values[implied] == 1;
+    }
+
+    /**
+     * Watch two non-false literals of the clause, returns the clause if it is falsified
+     * */
+    uint32_t attach(uint32_t clause) {
+        const Lit* lits = begin(clause);
+        size_t size = end(clause) - lits;
+        if (size == 0) {
+            return clause;
+        }
+        Lit* watch = &watched[2*clause];
+        watch[0] = watch[1] = lit_Undef;
+        for (size_t k = 0; k < size; k++) {
+            if (values[lits[k]] != -1) {
+                if (watch[0] == lit_Undef) watch[0] = lits[k];
+                else if (watch[1] == lit_Undef && lits[k] != watch[0]) watch[1] = lits[k];
+            }
+        }
+        for (size_t k = 0; k < size && (watch[0] == lit_Undef || watch[1] == lit_Undef); k++) {
+            if (watch[0] == lit_Undef) watch[0] = lits[k];
+            else if (lits[k] != watch[0]) watch[1] = lits[k];
+        }
+        if (watch[1] != lit_Undef) {
+            watches[watch[0]].push_back(clause);
+            watches[watch[1]].push_back(clause);
+        }
+        if (values[watch[0]] == -1) {
+            return clause;
+        }
+        if (values[watch[0]] == 0 && (watch[1] == lit_Undef || values[watch[1]] == -1)) {
+            assign(watch[0], clause);
+        }
+        return no_clause;
+    }
+
+    void detach(uint32_t clause) {
+        if (watched[2*clause+1] != lit_Undef) {
+            for (Lit lit : { watched[2*clause], watched[2*clause+1] }) {
+                std::vector<uint32_t>& list = watches[lit];
+                list.erase(std::find(list.begin(), list.end(), clause));
+            }
+        }
+    }
+
+    uint32_t propagate() {
+        while (head < assigned.size()) {
+            Lit falsified = ~assigned[head++];
+            std::vector<uint32_t>& list = watches[falsified];
+            auto keep = list.begin();
+            for (auto it = list.begin(); it != list.end(); it++) {
+                uint32_t clause = *it;
+                Lit* watch = &watched[2*clause];
+                if (watch[0] == falsified) std::swap(watch[0], watch[1]);
+                if (values[watch[0]] != 1) {
+                    for (const Lit* lit = begin(clause); lit != end(clause); lit++) {
+                        if (values[*lit] != -1 && *lit != watch[0] && *lit != watch[1]) {
+                            watch[1] = *lit;
+                            watches[*lit].push_back(clause);
+                            goto next_watcher;
+                        }
+                    }
+                    if (values[watch[0]] == -1) {
+                        list.erase(keep, it);
+                        return clause;
+                    }
+                    assign(watch[0], clause);
+                }
+                *keep++ = clause;
+                next_watcher:;
+            }
+            list.erase(keep, list.end());
+        }
+        return no_clause;
+    }
+
+    bool check_rup(const std::vector<Lit>& lits) {
+        size_t level = assigned.size();
+        bool conflict = false;
+        for (Lit lit : lits) {
+            if (values[lit] == 1) {
+                conflict = true;
+                break;
+            }
+            else if (values[lit] == 0) {
+                assign(~lit, no_clause);
+            }
+        }
+        if (!conflict) {
+            conflict = propagate() != no_clause;
+        }
+        backtrack(level);
+        return conflict;
+    }
+
+    bool check_lemma(uint32_t lemma) {
+        std::vector<Lit> lits(begin(lemma), end(lemma));
+        if (check_rup(lits)) {
+            return true;
+        }
+        // resolution asymmetric tautology on any pivot
+        for (Lit pivot : std::vector<Lit>(lits)) {
+            bool success = true;
+            for (uint32_t clause = 0; success && clause < active.size(); clause++) {
+                if (active[clause] && std::find(begin(clause), end(clause), ~pivot) != end(clause)) {
+                    lits.resize(end(lemma) - begin(lemma));
+                    for (const Lit* it = begin(clause); it != end(clause); it++) {
+                        if (*it != ~pivot) lits.push_back(*it);
+                    }
+                    success = check_rup(lits);
+                }
+            }
+            if (success) return true;
+        }
+        return false;
+    }
+
+public:
+    Worker(const DRATChecker& checker_, size_t first_step_, size_t last_step_) : 
+        checker(checker_), first_step(first_step_), last_step(last_step_), 
+        active(checker_.active.size(), true), watched(2 * checker_.active.size(), lit_Undef), 
+        watches(2 * checker_.reasons.size()), values(2 * checker_.reasons.size(), 0), 
+        reasons(checker_.reasons.size(), no_clause), assigned(), head(0), refuted(false)
+    { 
+        for (const Step& step : checker.steps) {
+            if (!step.deletion) active[step.clause] = false;
+        }
+        for (size_t i = 0; i < first_step; i++) {
+            active[checker.steps[i].clause] = !checker.steps[i].deletion;
+        }
+    }
+
+    bool isRefuted() const {
+        return refuted;
+    }
+
+    /**
+     * Returns false if a lemma of the slice is neither RUP nor RAT
+     * */
+    bool verify() {
+        for (uint32_t clause = 0; clause < active.size() && !refuted; clause++) {
+            if (active[clause]) refuted = attach(clause) != no_clause;
+        }
+        if (!refuted) refuted = propagate() != no_clause;
+
+        for (size_t i = first_step; i < last_step; i++) {
+            uint32_t clause = checker.steps[i].clause;
+            if (checker.steps[i].deletion) {
+                if (refuted || !is_reason(clause)) { // keep reasons of top-level assignments
+                    active[clause] = false;
+                    if (!refuted) detach(clause);
                 }
-                //std::cout << "d " << lits << "0" << std::endl;
-                check_clause_remove(lits.begin(), lits.end());
             }
             else {
-                lits.clear();
-                for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
-                    lits.push_back(Lit(abs(plit)-1, plit < 0));
-                }                
-                //std::cout << lits << "0" << std::endl;
-                if (!check_clause_add(lits.begin(), lits.end())) {
-                    //std::cout << "c *** Clause add failed: " << lits << std::endl;
+                if (!refuted && !check_lemma(clause)) {
                     return false;
                 }
+                active[clause] = true;
+                if (!refuted) refuted = attach(clause) != no_clause || propagate() != no_clause;
             }
-            in.skipWhitespace();
         }
+        return true;
+    }
+
+};
+
+/**
+ * Replay the proof until the conflict, then verify all lemmas forward in slices of 
+ * equally many lemmas (one per thread). The last worker must end in a conflict.
+ * */
+bool DRATChecker::check_proof_parallel(const char* filename, unsigned int threads) {
+    if (replay_proof(filename) == no_clause) {
+        return false;
+    }
+    size_t lemmas = std::count_if(steps.begin(), steps.end(), [](const Step& step) { return !step.deletion; });
+    if (lemmas == 0) {
+        return true;
+    }
+    threads = std::min<size_t>(threads, lemmas);
+
+    std::vector<size_t> bounds { 0 };
+    for (size_t i = 0, count = 0; i < steps.size(); i++) {
+        if (!steps[i].deletion && count++ == bounds.size() * lemmas / threads) {
+            bounds.push_back(i);
+        }
+    }
+    bounds.push_back(steps.size());
+
+    std::vector<char> verified(bounds.size() - 1, false);
+    bool refuted = false;
+    std::vector<std::thread> workers;
+    for (size_t k = 0; k + 1 < bounds.size(); k++) {
+        workers.emplace_back([this, &bounds, &verified, &refuted, k]() {
+            Worker worker(*this, bounds[k], bounds[k+1]);
+            verified[k] = worker.verify();
+            if (k + 2 == bounds.size()) refuted = worker.isRefuted();
+        });
     }
-    return clause_db.hasEmptyClause();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return refuted && std::all_of(verified.begin(), verified.end(), [](char ok) { return ok; });
+}
+
+template <typename Iterator>
+uint32_t DRATChecker::store_clause(Iterator begin, Iterator end) {
+    uint32_t clause = active.size();
+    for (Iterator it = begin; it != end; it++) {
+        Lit lit = *it;
+        if ((size_t)lit.var() >= reasons.size()) { // proof introduces new variables
+            size_t nVars = lit.var() + 1;
+            watches.resize(2 * nVars);
+            values.resize(2 * nVars, 0);
+            reasons.resize(nVars, no_clause);
+            positions.resize(nVars, 0);
+            seen.resize(nVars, 0);
+        }
+        literals.push_back(lit);
+    }
+    offsets.push_back(literals.size());
+    active.push_back(true);
+    core.push_back(false);
+    if (begin != end) arena_index.emplace(hash(begin, end), clause);
+    if (clause_size(clause) == 1) units.push_back(clause);
+    return clause;
+}
+
+template <typename Iterator>
+bool DRATChecker::same_literals(Iterator begin, Iterator end, const Lit* other_begin, const Lit* other_end) {
+    if (std::distance(begin, end) != std::distance(other_begin, other_end) 
+        || std::any_of(begin, end, [this](Lit lit) { return (size_t)lit.var() >= seen.size(); })) {
+        return false;
+    }
+    for (Iterator it = begin; it != end; it++) seen[it->var()] = 1 + it->sign();
+    bool same = std::all_of(other_begin, other_end, [this](Lit lit) { return seen[lit.var()] == 1 + lit.sign(); });
+    for (Iterator it = begin; it != end; it++) seen[it->var()] = 0;
+    return same;
+}
+
+/**
+ * Deactivate an active copy of the given clause unless it is a reason, returns its index if removed
+ * */
+template <typename Iterator>
+uint32_t DRATChecker::remove_clause(Iterator begin, Iterator end) {
+    auto range = arena_index.equal_range(hash(begin, end));
+    for (auto it = range.first; it != range.second; it++) {
+        uint32_t clause = it->second;
+        if (!is_reason(clause) && same_literals(begin, end, clause_begin(clause), clause_end(clause))) {
+            arena_index.erase(it);
+            active[clause] = false;
+            detach(clause);
+            return clause;
+        }
+    }
+    return no_clause;
+}
+
+bool DRATChecker::is_reason(uint32_t clause) {
+    return clause_size(clause) > 0 && reasons[clause_begin(clause)->var()] == clause 
+        && value(*clause_begin(clause)) == 1;
+}
+
+void DRATChecker::assign(Lit lit, uint32_t reason) {
+    values[lit] = 1;
+    values[~lit] = -1;
+    reasons[lit.var()] = reason;
+    positions[lit.var()] = assigned.size();
+    assigned.push_back(lit);
+}
+
+void DRATChecker::backtrack(size_t position) {
+    for (size_t i = position; i < assigned.size(); i++) {
+        values[assigned[i]] = 0;
+        values[~assigned[i]] = 0;
+        reasons[assigned[i].var()] = no_clause;
+    }
+    assigned.resize(std::min(position, assigned.size()));
+    core_head = std::min(core_head, position);
+    head = std::min(head, position);
+}
+
+/**
+ * Undo top-level assignments from the given position and propagate the remaining formula again
+ * */
+uint32_t DRATChecker::restart(size_t position) {
+    backtrack(position);
+    core_head = head = 0;
+    for (uint32_t unit : units) {
+        if (active[unit]) {
+            Lit lit = *clause_begin(unit);
+            if (value(lit) == -1) return unit;
+            if (value(lit) == 0) assign(lit, unit);
+        }
+    }
+    return propagate();
+}
+
+/**
+ * Watch two non-false literals of the clause, returns the clause if it is falsified
+ * */
+uint32_t DRATChecker::attach(uint32_t clause) {
+    Lit* lits = clause_begin(clause);
+    size_t size = clause_size(clause);
+    if (size == 0) {
+        return clause;
+    }
+    for (size_t pos = 0; pos < std::min<size_t>(size, 2); pos++) {
+        for (size_t k = pos; k < size; k++) {
+            if (value(lits[k]) != -1) {
+                std::swap(lits[pos], lits[k]);
+                break;
+            }
+        }
+    }
+    if (size > 1) {
+        watches[lits[0]].push_back(clause);
+        watches[lits[1]].push_back(clause);
+    }
+    if (value(lits[0]) == -1) {
+        return clause;
+    }
+    if (value(lits[0]) == 0 && (size == 1 || value(lits[1]) == -1)) {
+        assign(lits[0], clause);
+    }
+    return no_clause;
+}
+
+void DRATChecker::detach(uint32_t clause) {
+    if (clause_size(clause) > 1) {
+        for (Lit lit : { clause_begin(clause)[0], clause_begin(clause)[1] }) {
+            std::vector<uint32_t>& list = watches[lit];
+            list.erase(std::find(list.begin(), list.end(), clause));
+        }
+    }
+}
+
+/**
+ * Visit the clauses watching the falsified ~lit, either the core clauses or all others
+ * */
+uint32_t DRATChecker::propagate_literal(Lit lit, bool in_core) {
+    Lit falsified = ~lit;
+    std::vector<uint32_t>& list = watches[falsified];
+    auto keep = list.begin();
+    for (auto it = list.begin(); it != list.end(); it++) {
+        uint32_t clause = *it;
+        if ((bool)core[clause] == in_core) {
+            Lit* lits = clause_begin(clause);
+            if (lits[0] == falsified) std::swap(lits[0], lits[1]);
+            if (value(lits[0]) != 1) {
+                size_t size = clause_size(clause);
+                for (size_t k = 2; k < size; k++) {
+                    if (value(lits[k]) != -1) {
+                        std::swap(lits[1], lits[k]);
+                        watches[lits[1]].push_back(clause);
+                        goto next_watcher;
+                    }
+                }
+                if (value(lits[0]) == -1) {
+                    list.erase(keep, it);
+                    return clause;
+                }
+                assign(lits[0], clause);
+            }
+        }
+        *keep++ = clause;
+        next_watcher:;
+    }
+    list.erase(keep, list.end());
+    return no_clause;
+}
+
+uint32_t DRATChecker::propagate() {
+    while (head < assigned.size()) {
+        uint32_t conflict;
+        if (core_head < assigned.size()) {
+            conflict = propagate_literal(assigned[core_head++], true);
+        }
+        else {
+            conflict = propagate_literal(assigned[head++], false);
+        }
+        if (conflict != no_clause) return conflict;
+    }
+    return no_clause;
+}
+
+/**
+ * Mark the reasons of the given literals (transitively) as core
+ * */
+void DRATChecker::analyze(const Lit* begin, const Lit* end) {
+    size_t pending = 0;
+    for (const Lit* it = begin; it != end; it++) {
+        if (!seen[it->var()] && value(*it) != 0) {
+            seen[it->var()] = 1;
+            pending++;
+        }
+    }
+    for (size_t i = assigned.size(); pending > 0 && i-- > 0; ) {
+        Var var = assigned[i].var();
+        if (seen[var]) {
+            seen[var] = 0;
+            pending--;
+            uint32_t reason = reasons[var];
+            if (reason != no_clause) {
+                core[reason] = true;
+                for (Lit* it = clause_begin(reason); it != clause_end(reason); it++) {
+                    if (!seen[it->var()] && it->var() != var) {
+                        seen[it->var()] = 1;
+                        pending++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void DRATChecker::analyze(uint32_t conflict) {
+    core[conflict] = true;
+    analyze(clause_begin(conflict), clause_end(conflict));
+}
+
+/**
+ * Check if the negation of the literals propagates to a conflict and mark the involved clauses
+ * */
+bool DRATChecker::check_rup(const std::vector<Lit>& lits) {
+    size_t level = assigned.size();
+    bool conflict = false;
+    for (Lit lit : lits) {
+        if (value(lit) == 1) { 
+            analyze(&lit, &lit + 1);
+            conflict = true;
+            break;
+        }
+        else if (value(lit) == 0) {
+            assign(~lit, no_clause);
+        }
+    }
+    if (!conflict) {
+        uint32_t clause = propagate();
+        if (clause != no_clause) {
+            analyze(clause);
+            conflict = true;
+        }
+    }
+    backtrack(level);
+    return conflict;
+}
+
+bool DRATChecker::check_lemma(uint32_t lemma) {
+    std::vector<Lit> lits(clause_begin(lemma), clause_end(lemma));
+    if (check_rup(lits)) {
+        return true;
+    }
+    // resolution asymmetric tautology on any pivot
+    for (Lit pivot : std::vector<Lit>(lits)) {
+        bool success = true;
+        for (uint32_t clause = 0; success && clause < active.size(); clause++) {
+            if (active[clause] && std::find(clause_begin(clause), clause_end(clause), ~pivot) != clause_end(clause)) {
+                lits.resize(clause_size(lemma));
+                for (Lit* it = clause_begin(clause); it != clause_end(clause); it++) {
+                    if (*it != ~pivot) lits.push_back(*it);
+                }
+                success = check_rup(lits);
+                if (success) core[clause] = true;
+            }
+        }
+        if (success) return true;
+    }
+    return false;
 }
 
 template <typename Iterator>
@@ -132,6 +939,7 @@ bool DRATChecker::check_clause_add(Iterator begin, Iterator end) {
         for (Lit lit : *clause) {
             occurences[lit].push_back(clause);
         }
+        index.emplace(hash(clause->begin(), clause->end()), clause);
         if (clause->size() == 1 && !trail.fact(clause->first())) {
             clause_db.emptyClause();
         }
@@ -144,8 +952,11 @@ template <typename Iterator>
 bool DRATChecker::check_clause_remove(Iterator begin, Iterator end) {
     size_t size = std::distance(begin, end);
     if (size > 1) {
-        for (Clause* clause : occurences[*begin]) { // find clause and mark as deleted
-            if (size == clause->size() && std::all_of(begin+1, end, [clause](Lit lit) { return clause->contains(lit); })) {
+        auto range = index.equal_range(hash(begin, end));
+        for (auto it = range.first; it != range.second; it++) { // find clause and mark as deleted
+            Clause* clause = it->second;
+            if (same_literals(begin, end, clause->begin(), clause->end())) {
+                index.erase(it);
                 clause_db.removeClause(clause);
                 if (clause->size() > 2) {
                     propagation.detachClause(clause);
@@ -163,10 +974,12 @@ void DRATChecker::cleanup_deleted() {
     propagation.reset();
     occurences.clear();
     occurences.resize(2 * clause_db.nVars());
+    index.clear();
     for (Clause* clause : clause_db) {
         for (Lit lit : *clause) {
             occurences[lit].push_back(clause);
         }
+        index.emplace(hash(clause->begin(), clause->end()), clause);
     }
     num_deleted = 0;
 }
@@ -23,6 +23,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/Trail.h"
 #include "candy/core/systems/Propagation2WL.h"
 
+#include <unordered_map>
+
 #ifndef CANDY_DRAT_CHECKER
 #define CANDY_DRAT_CHECKER
 
@@ -30,6 +32,17 @@ typedef struct gzFile_s *gzFile;
 
 namespace Candy {
 
+/**
+ * Checks DRAT proofs either forward, verifying every lemma, or backward: all lemmas are added 
+ * without checks until the formula propagates to a conflict, then only the lemmas which take part 
+ * in the final conflict or in the check of another marked lemma are verified in reverse order. 
+ * Backward checking stores all clauses in a single arena and propagates marked (core) clauses first, 
+ * such that the marks spread over few clauses. 
+ * With several threads, the lemmas up to the conflict are verified in slices by workers which 
+ * propagate over the shared (then read-only) arena with their own assignment and watches. 
+ * LRAT proofs are detected by their content and checked by unit propagation over the given antecedents, 
+ * lemmas whose antecedents do not propagate to a conflict are rejected.
+ * */
 class DRATChecker {
 
 private:
@@ -38,9 +51,40 @@ private:
     Propagation2WL propagation;
 
     std::vector<std::vector<Clause*>> occurences;
+    std::unordered_multimap<uint64_t, Clause*> index; // clauses by hash of their literal set
 
     unsigned int num_deleted;
 
+    // backward checking: clauses of formula and proof referenced by their index in the arena
+    static const uint32_t no_clause = UINT32_MAX;
+
+    struct Step {
+        uint32_t clause;
+        bool deletion;
+    };
+
+    std::vector<Lit> literals;
+    std::vector<size_t> offsets;
+    std::vector<char> active;
+    std::vector<char> core;
+    std::vector<uint32_t> units;
+    std::vector<std::vector<uint32_t>> watches; // clauses watching the literal
+    std::unordered_multimap<uint64_t, uint32_t> arena_index; // active clauses by hash of their literal set
+    std::vector<Step> steps;
+
+    std::vector<signed char> values; // by literal: 1 true, -1 false
+    std::vector<uint32_t> reasons; // by variable
+    std::vector<uint32_t> positions; // by variable
+    std::vector<char> seen; // by variable
+    std::vector<Lit> assigned;
+    size_t core_head; // assignments propagated through core clauses
+    size_t head; // assignments propagated through all clauses
+
+    class Worker; // verifies a slice of the proof against the clauses active at each step
+
+    // LRAT checking: arena indices by clause id
+    std::vector<uint32_t> ids;
+
 public:
     DRATChecker(class CNFProblem& problem);
     ~DRATChecker();
@@ -51,6 +95,14 @@ public:
 private:
     bool check_proof(gzFile input_stream);
 
+    template <typename Callback>
+    bool read_proof(const char* filename, Callback callback);
+
+    bool check_proof_forward(const char* filename);
+    bool check_proof_backward(const char* filename);
+    bool check_proof_parallel(const char* filename, unsigned int threads);
+    bool check_proof_lrat(const char* filename);
+
     template <typename Iterator>
     bool check_clause_add(Iterator begin, Iterator end);
 
@@ -62,6 +114,54 @@ private:
 
     void cleanup_deleted();
 
+    template <typename Iterator>
+    static inline uint64_t hash(Iterator begin, Iterator end) {
+        return begin == end ? 0 : CNFProblem::fingerprint(&*begin, &*begin + std::distance(begin, end));
+    }
+
+    template <typename Iterator>
+    bool same_literals(Iterator begin, Iterator end, const Lit* other_begin, const Lit* other_end);
+
+    inline Lit* clause_begin(uint32_t clause) {
+        return literals.data() + offsets[clause];
+    }
+
+    inline Lit* clause_end(uint32_t clause) {
+        return literals.data() + offsets[clause+1];
+    }
+
+    inline size_t clause_size(uint32_t clause) const {
+        return offsets[clause+1] - offsets[clause];
+    }
+
+    inline signed char value(Lit lit) const {
+        return values[lit];
+    }
+
+    template <typename Iterator>
+    uint32_t store_clause(Iterator begin, Iterator end);
+
+    template <typename Iterator>
+    uint32_t remove_clause(Iterator begin, Iterator end);
+
+    void reset_arena();
+    uint32_t replay_proof(const char* filename);
+    uint32_t clause_by_id(int id);
+    bool check_hints(uint32_t lemma, const std::vector<int>& hints);
+
+    bool is_reason(uint32_t clause);
+    void assign(Lit lit, uint32_t reason);
+    void backtrack(size_t position);
+    uint32_t restart(size_t position);
+    uint32_t attach(uint32_t clause);
+    void detach(uint32_t clause);
+    uint32_t propagate_literal(Lit lit, bool in_core);
+    uint32_t propagate();
+    void analyze(const Lit* begin, const Lit* end);
+    void analyze(uint32_t conflict);
+    bool check_rup(const std::vector<Lit>& lits);
+    bool check_lemma(uint32_t lemma);
+
 };
 
 }
@@ -37,13 +37,16 @@ class ReduceDB {
     unsigned int nbclausesbeforereduce; // To know when it is time to reduce clause database
     unsigned int incReduceDB;
 
+    uint64_t lastReduce; // conflicts at the last reduction
+
 public:
     ReduceDB(ClauseDatabase& clause_db_, Trail& trail_)
      : clause_db(clause_db_), trail(trail_), nReduced(0), nReduceCalls_(1), 
         persistentLBD(ClauseDatabaseOptions::opt_persistent_lbd), 
         volatileLBD(ClauseDatabaseOptions::opt_volatile_lbd), 
         nbclausesbeforereduce(ClauseDatabaseOptions::opt_first_reduce_db),
-        incReduceDB(ClauseDatabaseOptions::opt_inc_reduce_db) { }
+        incReduceDB(ClauseDatabaseOptions::opt_inc_reduce_db), 
+        lastReduce(0) { }
     
     ~ReduceDB() { }
 
@@ -55,10 +58,9 @@ public:
         for (Reason reason : clause_db.result.involved_clauses) {
             if (reason.is_ptr()) {
                 Clause* clause = reason.get_ptr();
-                if (clause->getLBD() > persistentLBD) {
+                if (clause->getLBD() > persistentLBD && !clause->isDeleted()) {
                     uint8_t lbd = trail.computeLBD(clause->begin(), clause->end());
-                    clause->setLBD(lbd);
-                    clause->incUsed();
+                    clause_db.metadata.update(clause, lbd);
                 }
             }
         }
@@ -66,32 +68,44 @@ public:
     }
 
     /**
-     * only call this method at decision level 0
+     * only call this method at decision level 0. 
+     * Under memory pressure, all learnt clauses above the middle of the second tier are removed.
      **/
-    void reduce() { 
+    void reduce(bool pressure = false) { 
         assert(trail.decisionLevel() == 0);
         uint32_t reduced = 0;
-        for (Clause* learnt : clause_db) {
-            if (learnt->getLBD() > persistentLBD && !learnt->isDeleted()) {
-                if (learnt->getLBD() < volatileLBD) {
-                    if (learnt->decUsed() == 0) {
-                        clause_db.removeClause(learnt);
+        ClauseMetadata& metadata = clause_db.metadata;
+        const unsigned int cut = pressure ? (persistentLBD + volatileLBD) / 2 : UINT8_MAX;
+        for (uint32_t id : metadata) {
+            if (metadata.tier(id) != ClauseMetadata::CORE && !metadata.isDeleted(id)) {
+                if (metadata.lbd(id) > cut) {
+                    clause_db.removeClause(metadata.clause(id));
+                    ++reduced;
+                }
+                else if (metadata.tier(id) == ClauseMetadata::TIER2) {
+                    if (metadata.decUsed(id) == 0) {
+                        clause_db.removeClause(metadata.clause(id));
                         ++reduced;
                     }
                 }
-                else if (learnt->decUsed() <= 1) {
-                    clause_db.removeClause(learnt);
+                else if (metadata.decUsed(id) <= 1) {
+                    clause_db.removeClause(metadata.clause(id));
                     ++reduced;
                 }
             }
         }
         nbclausesbeforereduce += incReduceDB;
         nReduceCalls_++;
+        lastReduce = clause_db.result.nConflicts;
         nReduced += reduced;
         //std::cout << "c Reduced " << reduced << ", remaining " << clause_db.size() << std::endl;
     }
 
-    inline bool trigger_reduce() {
+    /* under memory pressure, reduce as soon as a quarter of the regular interval has passed */
+    inline bool trigger_reduce(bool pressure = false) {
+        if (pressure && lastReduce + nbclausesbeforereduce / 4 < clause_db.result.nConflicts) {
+            return true;
+        }
         if (nReduceCalls_ * nbclausesbeforereduce < clause_db.result.nConflicts) {
             return true;
         } 
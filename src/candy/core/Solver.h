@@ -64,6 +64,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/simplification/VariableElimination.h"
 
 #include "candy/core/clauses/ClauseDatabase.h"
+#include "candy/core/clauses/ClauseArena.h"
 #include "candy/core/clauses/Clause.h"
 #include "candy/core/CandySolverInterface.h"
 #include "candy/core/SolverTypes.h"
@@ -71,6 +72,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/Trail.h"
 #include "candy/core/CandySolverResult.h"
 
+#include "candy/mtl/HugePages.h"
 #include "candy/utils/Memory.h"
 #include "candy/utils/Runtime.h"
 
@@ -101,6 +103,10 @@ protected:
     unsigned int lastRestartWithInprocessing;
     unsigned int inprocessingFrequency;
 
+    unsigned int defragPages; // incremental defragmentation (0: reorganize on reduce)
+
+    size_t memoryLimit; // bytes of clauses, lists and clause metadata of all solvers in the process (0: no limit)
+
     // Interruption callback
     void* termCallbackState;
     int (*termCallback)(void* state);
@@ -112,6 +118,11 @@ protected:
 
     lbool search(); 
 
+    // bytes of clauses, watch and occurrence lists and clause metadata of all solvers (live counters, see ClauseArena and HugePages)
+    size_t memoryUsage() const {
+        return ClauseArena::used() + HugePages::allocated();
+    }
+
 public:
     Solver(CNFProblem& problem) : clause_db(problem), trail(problem),
         // subsystems
@@ -129,6 +140,8 @@ public:
         // pre- and inprocessing
         preprocessing_enabled(SolverOptions::opt_preprocessing),
         lastRestartWithInprocessing(0), inprocessingFrequency(SolverOptions::opt_inprocessing), 
+        defragPages(ClauseDatabaseOptions::opt_defrag_pages), 
+        memoryLimit((size_t)SolverOptions::memory_limit * 1024 * 1024), 
         // interruption callback
         termCallbackState(nullptr), termCallback([](void*) -> int { return 0; }),
         // learnt callback ipasir
@@ -267,6 +280,7 @@ lbool Solver<TPropagation, TLearning, TBranching>::search() {
         if (confl.exists()) { // CONFLICT
             if (trail.decisionLevel() == 0) {
                 if (verbosity > 1) std::cout << "c Conflict found by propagation at level 0" << std::endl;
+                clause_db.refute(trail, confl);
                 return l_False;
             }
             
@@ -274,7 +288,7 @@ lbool Solver<TPropagation, TLearning, TBranching>::search() {
             restart.process_conflict();
             reduce.process_conflict();
 
-            Clause* clause = clause_db.createClause(clause_db.result.learnt_clause.begin(), clause_db.result.learnt_clause.end(), clause_db.result.lbd);
+            Clause* clause = clause_db.createClause(clause_db.result.learnt_clause.begin(), clause_db.result.learnt_clause.end(), clause_db.result.lbd, false, clause_db.result.hints);
             if (clause->size() > 2) {
                 propagation.attachClause(clause);
             }
@@ -319,9 +333,12 @@ lbool Solver<TPropagation, TLearning, TBranching>::solve() {
 
     // materialized unit-clauses for sharing (Todo: Refactor)
     for (Lit lit : clause_db.unaries) {
-        if (!trail.fact(lit)) clause_db.emptyClause();
+        if (!trail.fact(lit)) clause_db.refute(trail, lit);
+    }
+    if (!clause_db.hasEmptyClause()) {
+        Reason conflict = propagation.propagate();
+        if (conflict.exists()) clause_db.refute(trail, conflict);
     }
-    if (propagation.propagate().exists()) { clause_db.emptyClause(); }    
     
     if (this->preprocessing_enabled) {
         std::cout << "c Preprocessing ... " << std::endl;
@@ -329,9 +346,12 @@ lbool Solver<TPropagation, TLearning, TBranching>::solve() {
         propagation.reset();
         // materialized unit-clauses for sharing (Todo: Refactor)
         for (Lit lit : clause_db.unaries) {
-            if (!trail.fact(lit)) clause_db.emptyClause();
+            if (!trail.fact(lit)) clause_db.refute(trail, lit);
+        }
+        if (!clause_db.hasEmptyClause()) {
+            Reason conflict = propagation.propagate();
+            if (conflict.exists()) clause_db.refute(trail, conflict);
         }
-        if (propagation.propagate().exists()) { clause_db.emptyClause(); }
     }
 
     lbool status = clause_db.hasEmptyClause() ? l_False : l_Undef;
@@ -340,17 +360,31 @@ lbool Solver<TPropagation, TLearning, TBranching>::solve() {
         trail.backtrack(0);
         branching.add_back(trail.conflict_rbegin(), trail.rbegin());
 
-        if (reduce.trigger_reduce()) {
-            if (inprocessingFrequency > 0 && lastRestartWithInprocessing + inprocessingFrequency <= reduce.nReduceCalls()) { 
+        bool pressure = memoryLimit > 0 && memoryUsage() > memoryLimit / 4 * 3; // reduce early and tighter, skip inprocessing
+        bool degraded = false;
+
+        if (reduce.trigger_reduce(pressure)) {
+            clause_db.antecedents.materialize(trail); // level 0 reasons might be removed or moved
+            bool reorganize = defragPages == 0 || SolverOptions::opt_sort_variables == 4 || SolverOptions::opt_sort_variables == 5 
+                || Stability::opt_sort_by_stability || SolverOptions::opt_sort_clauses || pressure;
+            if (!pressure && inprocessingFrequency > 0 && lastRestartWithInprocessing + inprocessingFrequency <= reduce.nReduceCalls()) { 
                 std::cout << "c Inprocessing ... " << std::endl;
                 lastRestartWithInprocessing = reduce.nReduceCalls();
                 processClauseDatabase();
+                reorganize = true;
             }
             else {
-                std::cout << "c Reducing ... " << std::endl;
-                reduce.reduce();
+                std::cout << (pressure ? "c Reducing under memory pressure ... " : "c Reducing ... ") << std::endl;
+                reduce.reduce(pressure);
+            }
+            if (!reorganize) {
+                clause_db.sweep(); // references to deleted clauses are dropped by the relocation below, then their memory is reused
+            }
+            else if (ClauseDatabaseOptions::opt_reorganize_by_watches) {
+                clause_db.reorganize(trail.trail, pressure); // the last assignment, beyond the current trail size
+            } else {
+                clause_db.reorganize({}, pressure); // under pressure the memory of the reduced clauses is released
             }
-            clause_db.reorganize();
 
             switch (SolverOptions::opt_sort_variables) {
                 case 4: for (Clause* c : clause_db) c->sort2(clause_db.occurrence, true); break;
@@ -370,14 +404,37 @@ lbool Solver<TPropagation, TLearning, TBranching>::solve() {
                 trail.nDecisions = trail.nDecisions >> Stability::opt_reset_stability; // nDecisions not reliable (todo: separate epoch counter)
             }
             
-            propagation.reset();
+            if (reorganize) {
+                propagation.reset();
+            }
+            if (pressure) {
+                propagation.shrink();
+                degraded = true;
+            }
             // materialized unit-clauses for sharing (Todo: Refactor)
             for (Lit lit : clause_db.unaries) {
-                if (!trail.fact(lit)) clause_db.emptyClause();
+                if (!trail.fact(lit)) clause_db.refute(trail, lit);
+            }
+        }
+
+        if (defragPages > 0) {
+            const ClauseForwarding& forwarding = clause_db.defragment(defragPages);
+            if (!forwarding.empty()) {
+                propagation.relocate(forwarding);
+                trail.relocate(forwarding);
+                clause_db.release_evacuated();
             }
         }
 
-        if (propagation.propagate().exists()) { clause_db.emptyClause(); }
+        if (degraded && memoryUsage() > memoryLimit) { // the limit can not be kept by reductions
+            std::cout << "c Memory limit exceeded" << std::endl;
+            break;
+        }
+
+        if (!clause_db.hasEmptyClause()) {
+            Reason conflict = propagation.propagate();
+            if (conflict.exists()) clause_db.refute(trail, conflict);
+        }
 
         if (clause_db.hasEmptyClause()) {
             status = l_False;
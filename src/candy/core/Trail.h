@@ -44,6 +44,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <vector>
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/CNFProblem.h"
 #include "candy/mtl/Stamp.h"
 
@@ -474,6 +475,21 @@ public:
         }
     }
 
+    /* follow the reasons of current assignments into evacuated pages, reasons which were deleted are dropped */
+    void relocate(const ClauseForwarding& forwarding) {
+        for (unsigned int i = 0; i < trail_size; i++) {
+            Reason& reason = reasons[trail[i].var()];
+            if (reason.is_ptr()) {
+                Clause* clause = reason.get_ptr();
+                if (forwarding.relocate(clause)) {
+                    reason.set(clause);
+                } else {
+                    reason.unset();
+                }
+            }
+        }
+    }
+
     /**
      * Count the number of decision levels in which the given list of literals was assigned
      */
@@ -0,0 +1,277 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2020, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_CANDY_CORE_ANTECEDENTS_H_
+#define SRC_CANDY_CORE_ANTECEDENTS_H_
+
+#include <vector>
+#include <unordered_map>
+
+#include "candy/core/SolverTypes.h"
+#include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/Certificate.h"
+#include "candy/core/Trail.h"
+
+namespace Candy {
+
+/**
+ * Hands out stable clause ids and, in LRAT mode, derives the antecedents (hints) of lemmas 
+ * from the reasons on the trail. Facts at level 0 are referenced by unit lemmas which are 
+ * written to the certificate on demand, such that hints never depend on level 0 reasons 
+ * which are deleted or moved later.
+ * */
+class Antecedents {
+private:
+    Certificate& certificate;
+    bool enabled;
+    uint32_t next_id;
+
+    std::vector<uint32_t> units; // id of unit clause per literal
+    std::unordered_multimap<uint64_t, uint32_t> binaries; // ids of binary clauses by literal pair
+    std::vector<uint8_t> marks; // per variable: 1 needs antecedent, 2 negated lemma literal
+
+    std::vector<uint32_t> chain;
+    std::vector<Var> stack;
+    std::vector<uint32_t> unit_hints;
+
+    static inline Lit fact(const Trail& trail, Var var) {
+        return trail.value(var) == l_True ? Lit(var, false) : Lit(var, true);
+    }
+
+    static inline uint64_t key(Lit lit1, Lit lit2) {
+        if (lit2 < lit1) std::swap(lit1, lit2);
+        return (static_cast<uint64_t>(lit1.x) << 32) | static_cast<uint32_t>(lit2.x);
+    }
+
+    uint32_t binary(Lit lit1, Lit lit2) const {
+        auto it = binaries.find(key(lit1, lit2));
+        return it == binaries.end() ? 0 : it->second;
+    }
+
+public:
+    Antecedents(Certificate& certificate_, unsigned int nVars) : 
+        certificate(certificate_), enabled(certificate_.isLRAT()), next_id(1), 
+        units(enabled ? 2 * nVars : 0, 0), binaries(), marks(enabled ? nVars : 0, 0), 
+        chain(), stack(), unit_hints() 
+    { }
+
+    inline bool active() const {
+        return enabled;
+    }
+
+    inline uint32_t next() {
+        return next_id++;
+    }
+
+    /* continue with the given id, the ids in between are not used (e.g. those of dropped input clauses) */
+    inline void advance(uint32_t id) {
+        assert(id >= next_id);
+        next_id = id;
+    }
+
+    /* without LRAT ids are not referenced by the certificate and can be handed out again */
+    inline void rewind(uint32_t id) {
+        assert(!enabled);
+        next_id = id;
+    }
+
+    void grow(unsigned int nVars) {
+        if (enabled && marks.size() < nVars) {
+            units.resize(2 * nVars, 0);
+            marks.resize(nVars, 0);
+        }
+    }
+
+    void add(const Clause* clause) {
+        if (enabled) {
+            if (clause->size() == 1) {
+                units[clause->first()] = clause->id();
+            }
+            else if (clause->size() == 2) {
+                binaries.emplace(key(clause->first(), clause->second()), clause->id());
+            }
+        }
+    }
+
+    void remove(const Clause* clause) {
+        if (enabled) {
+            if (clause->size() == 1 && units[clause->first()] == clause->id()) {
+                units[clause->first()] = 0;
+            }
+            else if (clause->size() == 2) {
+                auto range = binaries.equal_range(key(clause->first(), clause->second()));
+                for (auto it = range.first; it != range.second; it++) {
+                    if (it->second == clause->id()) {
+                        binaries.erase(it);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    uint32_t id(Reason reason) const {
+        if (reason.is_ptr()) {
+            return reason.get_ptr()->id();
+        }
+        return binary(*reason.begin(), *(reason.begin()+1));
+    }
+
+    /* id of the unit clause of the literal (0 if there is none) */
+    inline uint32_t unit(Lit lit) const {
+        return units[lit];
+    }
+
+    /**
+     * Id of a unit clause for the level 0 assignment of the variable (0 if it can not be derived). 
+     * Missing units are derived from their reasons and written to the certificate.
+     * */
+    uint32_t unit(Trail& trail, Var var) {
+        if (units[fact(trail, var)] != 0) {
+            return units[fact(trail, var)];
+        }
+        stack.clear();
+        stack.push_back(var);
+        while (!stack.empty()) {
+            Var current = stack.back();
+            if (units[fact(trail, current)] != 0) {
+                stack.pop_back();
+                continue;
+            }
+            Reason reason = trail.reason(current);
+            if (!reason.exists() || trail.level(current) > 0) {
+                return 0;
+            }
+            size_t size = stack.size();
+            for (Lit lit : reason) {
+                if (lit.var() != current && units[~lit] == 0) {
+                    stack.push_back(lit.var());
+                }
+            }
+            if (stack.size() > size) {
+                continue;
+            }
+            unit_hints.clear();
+            for (Lit lit : reason) {
+                if (lit.var() != current) unit_hints.push_back(units[~lit]);
+            }
+            unit_hints.push_back(id(reason));
+            if (unit_hints.back() == 0) {
+                return 0;
+            }
+            Lit lit = fact(trail, current);
+            units[lit] = next();
+            certificate.added(&lit, &lit + 1, units[lit], unit_hints);
+            stack.pop_back();
+        }
+        return units[fact(trail, var)];
+    }
+
+    /**
+     * Write unit lemmas for all assignments at level 0, before their reasons are deleted or moved
+     * */
+    void materialize(Trail& trail) {
+        if (enabled) {
+            size_t end = trail.decisionLevel() > 0 ? trail.trail_lim[0] : trail.size();
+            for (size_t i = 0; i < end; i++) {
+                unit(trail, trail[i].var());
+            }
+        }
+    }
+
+    /**
+     * Derive the antecedents of the lemma, which is falsified by the trail, from the conflict: 
+     * the reasons of all involved assignments in trail order and the conflict last. 
+     * The hints are cleared if some assignment can not be explained.
+     * */
+    template<typename Iterator>
+    void derive(Trail& trail, Iterator begin, Iterator end, Reason conflict, std::vector<uint32_t>& hints) {
+        hints.clear();
+        if (!enabled || !conflict.exists()) return;
+
+        for (Iterator it = begin; it != end; it++) {
+            marks[it->var()] = 2;
+        }
+        size_t pending = 0;
+        for (Lit lit : conflict) {
+            if (marks[lit.var()] == 0) {
+                marks[lit.var()] = 1;
+                pending++;
+            }
+        }
+
+        Lit first = begin != end ? *begin : lit_Undef;
+        bool success = true;
+        chain.clear();
+        for (size_t i = trail.size(); pending > 0 && i-- > 0; ) {
+            Lit lit = trail[i];
+            Var var = lit.var();
+            if (marks[var] != 1) continue;
+            marks[var] = 0;
+            pending--;
+            uint32_t antecedent = 0;
+            if (trail.level(var) == 0) {
+                antecedent = unit(trail, var);
+            }
+            else if (first != lit_Undef && (antecedent = binary(first, lit)) != 0) {
+                // implied by the negation of the first literal (binary minimization)
+            }
+            else {
+                Reason reason = trail.reason(var);
+                if (reason.exists()) {
+                    antecedent = id(reason);
+                    for (Lit other : reason) {
+                        if (marks[other.var()] == 0 && other.var() != var) {
+                            marks[other.var()] = 1;
+                            pending++;
+                        }
+                    }
+                }
+            }
+            if (antecedent == 0) {
+                success = false;
+                break;
+            }
+            chain.push_back(antecedent);
+        }
+
+        if (success && pending == 0) {
+            hints.assign(chain.rbegin(), chain.rend());
+            hints.push_back(id(conflict));
+            if (hints.back() == 0) hints.clear();
+        }
+
+        for (Iterator it = begin; it != end; it++) {
+            marks[it->var()] = 0;
+        }
+        for (Lit lit : conflict) {
+            marks[lit.var()] = 0;
+        }
+        if (!success || pending > 0) { // clear remaining marks
+            for (size_t i = 0; i < trail.size(); i++) {
+                marks[trail[i].var()] = 0;
+            }
+        }
+    }
+
+};
+
+}
+
+#endif
@@ -23,12 +23,13 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 
 #include "candy/core/clauses/Clause.h"
+#include "candy/mtl/HugePages.h"
 
 namespace Candy {
 
 class BinaryClauses {
 public:
-    std::vector<std::vector<Lit>> binary_watchers;
+    std::vector<HugePageVector<Lit>> binary_watchers;
 
     BinaryClauses(unsigned int nVars) : binary_watchers() {
         binary_watchers.resize(2*nVars);
@@ -38,7 +39,13 @@ public:
         for (auto& w : binary_watchers) w.clear();
     }
 
-    inline const std::vector<Lit>& operator [](Lit p) const {
+    void grow(unsigned int nVars) {
+        if (binary_watchers.size() < 2*nVars) {
+            binary_watchers.resize(2*nVars);
+        }
+    }
+
+    inline const HugePageVector<Lit>& operator [](Lit p) const {
         return binary_watchers[p];
     }
 
@@ -50,8 +57,8 @@ public:
 
     void remove(Clause* clause) {
         assert(clause->size() == 2);
-        std::vector<Lit>& list0 = binary_watchers[~clause->first()];
-        std::vector<Lit>& list1 = binary_watchers[~clause->second()];
+        HugePageVector<Lit>& list0 = binary_watchers[~clause->first()];
+        HugePageVector<Lit>& list1 = binary_watchers[~clause->second()];
         auto it0 = std::find(list0.begin(), list0.end(), clause->second());
         auto it1 = std::find(list1.begin(), list1.end(), clause->first());
         assert(it0 != list0.end() && it1 != list1.end());
@@ -24,33 +24,238 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include <archive.h>
+#include <archive_entry.h>
 
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/mtl/SPSCRing.h"
 
 namespace Candy {
 
 class Clause;
 
+/**
+ * Writes DRAT proofs in text or binary encoding. Lines are collected in a large buffer which is 
+ * written without per-line flushes. The buffer is flushed when the empty clause is written.
+ * In asynchronous mode full buffers are copied to a lock-free ring which is drained to the file 
+ * by a writer thread, such that the solver never blocks on file i/o unless the ring is full.
+ * Output files ending in .gz, .bz2, .xz, .lzma or .zst are compressed through libarchive, 
+ * such compressed proofs are complete only after the empty clause was written or on close.
+ * In LRAT mode lines carry clause ids and the ids of their antecedents (hints), every lemma has to 
+ * be derivable by unit propagation over its hints. LRAT is always written as text.
+ * Write errors (e.g. a full disk) stop the output and are reported once on finish or close.
+ * */
 class Certificate {
 private:
     bool active;
+    bool binary;
+    bool lrat;
+    uint32_t last_id;
     std::ofstream out;
+    struct archive* compressed;
+    std::vector<char> buffer;
+    size_t used;
+
+    std::unique_ptr<SPSCRing> ring;
+    std::thread writer;
+    std::atomic<bool> stopped;
+    std::atomic<size_t> synced; // ring bytes which reached the file
+    std::atomic<bool> failed;
+    std::string failure; // set by the thread which sets failed
+    bool reported;
+
+    static const size_t buffer_size = 1 << 20;
+    static const size_t ring_size = 1 << 24;
+
+    inline void reserve(size_t bytes) {
+        if (used + bytes > buffer_size) emit();
+    }
+
+    typedef int (*Filter)(struct archive*);
+
+    static Filter compression(const std::string& filename) {
+        static const struct { const char* extension; Filter filter; } filters[] = {
+            { ".gz", archive_write_add_filter_gzip }, { ".bz2", archive_write_add_filter_bzip2 }, 
+            { ".xz", archive_write_add_filter_xz }, { ".lzma", archive_write_add_filter_lzma }, 
+            { ".zst", archive_write_add_filter_zstd }
+        };
+        for (auto& entry : filters) {
+            size_t length = strlen(entry.extension);
+            if (filename.size() > length && filename.compare(filename.size() - length, length, entry.extension) == 0) {
+                return entry.filter;
+            }
+        }
+        return nullptr;
+    }
+
+    bool open_compressed(const char* filename, Filter filter) {
+        compressed = archive_write_new();
+        struct archive_entry* entry = archive_entry_new();
+        archive_entry_set_filetype(entry, AE_IFREG);
+        bool success = filter(compressed) == ARCHIVE_OK
+            && archive_write_set_format_raw(compressed) == ARCHIVE_OK
+            && archive_write_set_bytes_in_last_block(compressed, 1) == ARCHIVE_OK
+            && archive_write_open_filename(compressed, filename) == ARCHIVE_OK
+            && archive_write_header(compressed, entry) == ARCHIVE_OK;
+        archive_entry_free(entry);
+        if (!success) {
+            archive_write_free(compressed);
+            compressed = nullptr;
+        }
+        return success;
+    }
+
+    void fail(const char* reason) {
+        bool expected = false;
+        if (failed.compare_exchange_strong(expected, true)) {
+            failure = reason != nullptr ? reason : "unknown error";
+        }
+    }
+
+    inline void write(const char* data, size_t size) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (compressed) {
+            if (archive_write_data(compressed, data, size) < 0) {
+                fail(archive_error_string(compressed));
+            }
+        }
+        else if (!out.write(data, size)) {
+            fail("write error");
+        }
+    }
+
+    // the compressed stream can not be synced before it is closed
+    inline void sync() {
+        if (!compressed && !failed.load(std::memory_order_relaxed) && !out.flush()) {
+            fail("write error");
+        }
+    }
+
+    void report() {
+        if (failed.load(std::memory_order_acquire) && !reported) {
+            std::cout << "c Could not write proof: " << failure << std::endl;
+            reported = true;
+        }
+    }
+
+    // hand the buffer over to the file or the ring
+    inline void emit() {
+        if (used > 0) {
+            if (ring) {
+                size_t pushed = 0;
+                while ((pushed += ring->push(buffer.data() + pushed, used - pushed)) < used) {
+                    std::this_thread::yield();
+                }
+            }
+            else {
+                write(buffer.data(), used);
+            }
+        }
+        used = 0;
+    }
+
+    void drain() {
+        const char* begin;
+        while (true) {
+            size_t size = ring->peek(begin);
+            if (size > 0) {
+                write(begin, size);
+                ring->pop(size);
+            }
+            else {
+                size_t read = ring->read();
+                if (synced.load(std::memory_order_relaxed) != read) {
+                    sync();
+                    synced.store(read, std::memory_order_release);
+                }
+                else if (stopped.load(std::memory_order_acquire)) {
+                    if (ring->written() == read) break;
+                }
+                else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        }
+    }
+
+    inline void printInteger(int64_t value) {
+        char digits[21];
+        char* end = digits + sizeof(digits);
+        char* begin = end;
+        uint64_t magnitude = value < 0 ? -static_cast<uint64_t>(value) : value;
+        do {
+            *--begin = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while (magnitude > 0);
+        if (value < 0) *--begin = '-';
+        std::copy(begin, end, buffer.data() + used);
+        used += end - begin;
+    }
 
     template<typename Iterator>
     inline void printLiterals(Iterator it, Iterator end) {
         for(; it != end; it++) {
-            out << (it->var() + 1) * (it->sign() ? -1 : 1) << " ";
+            reserve(12);
+            if (binary) { // variable-length encoding of 2*var+sign (with 1-based variables)
+                unsigned int value = 2 * (it->var() + 1) + (it->sign() ? 1 : 0);
+                while (value > 127) {
+                    buffer[used++] = static_cast<char>(128 | (value & 127));
+                    value >>= 7;
+                }
+                buffer[used++] = static_cast<char>(value);
+            }
+            else {
+                printInteger((it->var() + 1) * (it->sign() ? -1 : 1));
+                buffer[used++] = ' ';
+            }
+        }
+        reserve(2);
+        if (binary) {
+            buffer[used++] = 0;
+        }
+        else {
+            buffer[used++] = '0';
+            buffer[used++] = '\n';
         }
-        out << "0" << std::endl;
+    }
+
+    inline void printHints(uint32_t id, const std::vector<uint32_t>& hints) {
+        for (uint32_t hint : hints) {
+            reserve(12);
+            printInteger(hint);
+            buffer[used++] = ' ';
+        }
+        reserve(2);
+        buffer[used++] = '0';
+        buffer[used++] = '\n';
+        last_id = id;
     }
 
 public:
-    Certificate(const char* _out) : active(false), out() {
-        out.open(_out, std::ios::out | std::ios::trunc );
+    Certificate(const char* _out, bool _binary = false, bool _async = false, bool _lrat = false) 
+        : active(false), binary(_binary && !_lrat), lrat(_lrat), last_id(0), out(), compressed(nullptr), buffer(), used(0), ring(), writer(), stopped(false), synced(0), failed(false), failure(), reported(false) 
+    {
+        Filter filter = compression(_out);
+        if (filter == nullptr || !open_compressed(_out, filter)) {
+            out.open(_out, std::ios::out | std::ios::trunc | std::ios::binary);
+        }
 
-        if (out.is_open()) {
+        if (out.is_open() || compressed) {
             this->active = true;
+            buffer.resize(buffer_size);
+            if (_async) {
+                ring.reset(new SPSCRing(ring_size));
+                writer = std::thread(&Certificate::drain, this);
+            }
         }
     }
 
@@ -58,28 +263,134 @@ public:
         close();
     }
 
+    /** 
+     * Write all pending lines to the file, in asynchronous mode this waits for the writer thread
+     * */
+    inline void flush() {
+        if (active) {
+            emit();
+            if (ring) {
+                size_t target = ring->written();
+                while (synced.load(std::memory_order_acquire) < target) {
+                    std::this_thread::yield();
+                }
+            }
+            else {
+                sync();
+            }
+        }
+    }
+
     inline void close() {
-        if (out.is_open()) out.close();
+        if (active) emit();
+        if (writer.joinable()) {
+            stopped.store(true, std::memory_order_release);
+            writer.join();
+        }
+        if (compressed) {
+            if (archive_write_close(compressed) != ARCHIVE_OK && !failed) {
+                fail(archive_error_string(compressed));
+            }
+            archive_write_free(compressed);
+            compressed = nullptr;
+        }
+        if (out.is_open()) {
+            out.close();
+            if (out.fail() && !failed) fail("write error");
+        }
         active = false;
+        report();
+    }
+
+    /** 
+     * Make the proof readable after the empty clause, compressed streams are finalized 
+     * */
+    inline void finish() {
+        if (compressed) {
+            close();
+        }
+        else {
+            flush();
+            report();
+        }
+    }
+
+    /** 
+     * False if writing the proof failed, the proof file is incomplete then
+     * */
+    inline bool good() const {
+        return !failed.load(std::memory_order_acquire);
     }
 
-    inline void proof() {
+    inline bool isLRAT() const {
+        return active && lrat;
+    }
+
+    inline void proof(uint32_t id = 0, const std::vector<uint32_t>& hints = std::vector<uint32_t>()) {
         if (active) {
-            out << "0" << std::endl;
+            reserve(24);
+            if (binary) {
+                buffer[used++] = 'a';
+                buffer[used++] = 0;
+            }
+            else if (lrat) {
+                printInteger(id);
+                buffer[used++] = ' ';
+                buffer[used++] = '0';
+                buffer[used++] = ' ';
+                printHints(id, hints);
+            }
+            else {
+                buffer[used++] = '0';
+                buffer[used++] = '\n';
+            }
+            finish();
         }
     }
 
     template<typename Iterator>
-    inline void added(Iterator it, Iterator end) {
+    inline void added(Iterator it, Iterator end, uint32_t id = 0, const std::vector<uint32_t>& hints = std::vector<uint32_t>()) {
         if (active) {
-            printLiterals(it, end);
+            reserve(24);
+            if (binary) buffer[used++] = 'a';
+            if (lrat) {
+                printInteger(id);
+                buffer[used++] = ' ';
+                for (Iterator lit = it; lit != end; lit++) {
+                    reserve(12);
+                    printInteger((lit->var() + 1) * (lit->sign() ? -1 : 1));
+                    buffer[used++] = ' ';
+                }
+                reserve(2);
+                buffer[used++] = '0';
+                buffer[used++] = ' ';
+                printHints(id, hints);
+            }
+            else {
+                printLiterals(it, end);
+            }
+            if (it == end) finish();
         }
     }
 
     template<typename Iterator>
-    inline void removed(Iterator it, Iterator end) {
+    inline void removed(Iterator it, Iterator end, uint32_t id = 0) {
         if (active) {
-            out << "d ";
+            reserve(48);
+            if (lrat) {
+                last_id = std::max(last_id, id); // deletions before the first lemma
+                printInteger(last_id);
+                buffer[used++] = ' ';
+                buffer[used++] = 'd';
+                buffer[used++] = ' ';
+                printInteger(id);
+                buffer[used++] = ' ';
+                buffer[used++] = '0';
+                buffer[used++] = '\n';
+                return;
+            }
+            buffer[used++] = 'd';
+            if (!binary) buffer[used++] = ' ';
             printLiterals(it, end);
         }
     }
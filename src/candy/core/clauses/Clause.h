@@ -46,7 +46,9 @@ class Clause {
     // in case I ever have to handle concurrency issues again
     friend class ClauseAllocatorMemory;
     friend class ClauseAllocator;
+    friend class ClauseForwarding;
     friend class ClauseDatabase;
+    friend class ClauseMetadata;
     friend class Subsumption;
     friend class Propagation2WL;
     friend class Propagation2WLStable1WOpt;
@@ -59,9 +61,8 @@ class Clause {
 private:
     uint16_t length;
     uint8_t weight;
-    uint8_t used;
 
-    uint32_t abstraction;
+    uint32_t identifier; // stable id in proofs
 
     Lit literals[1];
 
@@ -80,25 +81,10 @@ private:
         weight = lbd;
     }
 
-    inline uint8_t incUsed() {
-        return used < 3 ? ++used : used;
-    }
-
-    inline uint8_t decUsed() {
-        return used > 0 ? --used : used;
-    }
-
     inline void setDeleted() {
         weight = std::numeric_limits<uint8_t>::max();
     }
 
-    inline void calc_abstraction() {
-        abstraction = 0;
-        for (Lit lit : *this) {
-            abstraction |= 1ull << (lit.var() % 32);
-        }
-    }
-
 public:
     template<typename T>
     inline void sort(std::vector<T>& o, bool asc) {
@@ -135,8 +121,7 @@ public:
         copyLiterals(begin, end, literals);
         length = static_cast<decltype(length)>(std::distance(begin, end));
         weight = cast_uint8_t(lbd); // not frozen, not deleted and not learnt; lbd=0
-        used = 2;
-        calc_abstraction();
+        identifier = 0;
         assert(lbd <= length);
     }
     
@@ -164,6 +149,10 @@ public:
         return length;
     }
 
+    inline uint32_t id() const {
+        return identifier;
+    }
+
     inline const Lit first() const {
         return literals[0];
     }
@@ -216,8 +205,17 @@ public:
         return weight;
     }
 
+    /* abstraction of the variables for quick subsumption checks */
+    inline uint32_t abstraction() const {
+        uint32_t result = 0;
+        for (Lit lit : *this) {
+            result |= 1ull << (lit.var() % 32);
+        }
+        return result;
+    }
+
     inline bool equals(const Clause* other) const {
-        if (this->abstraction == other->abstraction && this->size() == other->size()) {
+        if (this->size() == other->size()) {
             for (Lit lit : *this) {
                 if (!other->contains(lit)) {
                     return false;
@@ -233,7 +231,7 @@ public:
      *
      *  Description:
      *       Checks if clause subsumes 'other', and at the same time, if it can be used to simplify 'other'
-     *       by subsumption resolution.
+     *       by subsumption resolution. Callers filter candidates by their abstraction().
      *
      *    Result:
      *       lit_Error  - No subsumption or simplification
@@ -241,7 +239,7 @@ public:
      *       p          - The literal p can be deleted from 'other'
      */
     inline Lit subsumes(const Clause* other) const {
-        if ((abstraction & ~(other->abstraction)) == 0 && other->size() >= this->size()) {
+        if (other->size() >= this->size()) {
             Lit ret = lit_Undef;
             for (Lit c : *this) {
                 for (Lit d : *other) { // search for c or ~c
@@ -40,6 +40,7 @@ public:
     ClauseAllocator() : 
         memory(32), facts(1), 
         global_database_size_bound(ParallelOptions::opt_static_database_size_bound),
+        reorganize_threshold(ClauseDatabaseOptions::opt_reorganize_threshold),
         global_allocator(nullptr), memory_lock(), ready(), ready_lock() { }
 
     ~ClauseAllocator() { }
@@ -61,6 +62,9 @@ public:
     }
 
     inline void deallocate(Clause* clause) {
+        if (!clause->isDeleted()) {
+            memory.release(clause); // ignored for facts and clauses of the global allocator
+        }
         clause->setDeleted();
     }
 
@@ -80,9 +84,28 @@ public:
         facts.clear();
     }
 
-    void reorganize() {
-        memory.reallocate();
-        memory.free_phase_out_pages();
+    /* a defragmentation is due, otherwise reorganize() only recycles the memory of deleted clauses */
+    inline bool fragmented() {
+        return memory.fragmented(reorganize_threshold);
+    }
+
+    /**
+     * Compact the fragmented pages, or relocate all clauses if an order is given. 
+     * Forced compaction (e.g. under memory pressure) evacuates every page with deleted clauses. 
+     * References to deleted or moved clauses are invalid afterwards.
+     * */
+    void reorganize(const std::vector<Clause*>& order = {}, bool compact = false) {
+        if (compact || fragmented()) {
+            if (order.empty()) {
+                memory.compact(compact ? 0 : reorganize_threshold);
+            } else {
+                memory.reallocate(order);
+            }
+            memory.free_phase_out_pages();
+        }
+        else {
+            memory.recycle();
+        }
 
         if (global_allocator != nullptr) {
             if (global_allocator->everybody_ready()) { // all threads use new pages now
@@ -96,6 +119,20 @@ public:
         }
     }
 
+    /* evacuate fragmented pages, the forwarding table has to be applied before release_evacuated() */
+    void evacuate(unsigned int max_pages, ClauseForwarding& forwarding) {
+        memory.evacuate(max_pages, reorganize_threshold, forwarding);
+    }
+
+    void release_evacuated() {
+        memory.free_phase_out_pages();
+    }
+
+    /* make the memory of deleted clauses available for new clauses, no references to them may be left */
+    void recycle() {
+        memory.recycle();
+    }
+
     std::vector<Clause*> collect() {
         std::vector<Clause*> clauses = memory.collect();
         std::vector<Clause*> unit_clauses = facts.collect();
@@ -133,6 +170,7 @@ private:
     ClauseAllocatorMemory facts;
 
     const unsigned int global_database_size_bound;
+    const unsigned int reorganize_threshold;
 
     // global allocator for multi-threaded scenario    
     ClauseAllocator* global_allocator;
@@ -24,9 +24,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <cstring> 
 #include <assert.h>
 #include <memory.h>
+#include <vector>
+#include <algorithm>
 
 #include <candy/core/clauses/Clause.h>
-#include <candy/core/clauses/ClauseAllocator.h>
+#include <candy/core/clauses/ClauseArena.h>
+#include <candy/core/clauses/ClauseForwarding.h>
 
 namespace Candy {
 
@@ -64,26 +67,28 @@ public:
 private:
     size_t page_size;
     size_t cursor;
+    size_t dead; // bytes of deleted clauses (free slots included)
     unsigned char* memory;
 
     ClauseAllocatorPage(ClauseAllocatorPage const&) = delete;
     void operator=(ClauseAllocatorPage const&) = delete;
 
 public:
-    ClauseAllocatorPage(size_t page_size_) : page_size(page_size_), cursor(0) {
-        memory = (unsigned char*)std::malloc(page_size);
-        // std::memset(memory, page_size, 0);
+    ClauseAllocatorPage(size_t page_size_) : page_size(page_size_), cursor(0), dead(0) {
+        memory = (unsigned char*)ClauseArena::acquire(page_size);
     }
 
-    ClauseAllocatorPage(ClauseAllocatorPage&& other) : page_size(other.page_size), cursor(other.cursor), memory(other.memory) {
+    ClauseAllocatorPage(ClauseAllocatorPage&& other) : page_size(other.page_size), cursor(other.cursor), dead(other.dead), memory(other.memory) {
         other.page_size = 0;
         other.cursor = 0;
+        other.dead = 0;
         other.memory = nullptr;
     }
 
     ~ClauseAllocatorPage() {
         if (memory != nullptr) {
-            std::free((void*)memory);
+            ClauseArena::vacate(cursor);
+            ClauseArena::release((void*)memory, page_size);
             memory = nullptr;
         }
     }
@@ -97,6 +102,7 @@ public:
         assert(memory != nullptr);
         void* result = memory + cursor;
         cursor += clauseBytes(length);
+        ClauseArena::occupy(clauseBytes(length));
         assert(cursor < page_size);
         return result;
     }
@@ -118,12 +124,34 @@ public:
     }
 
     inline void reset() {
+        ClauseArena::vacate(cursor);
         cursor = 0;
+        dead = 0;
     }
 
-    inline bool contains(void* p) const {
+    inline size_t garbage() const {
+        return dead;
+    }
+
+    inline size_t live() const {
+        return cursor - dead;
+    }
+
+    inline void discard(size_t bytes) {
+        dead += bytes;
+    }
+
+    inline void revive(size_t bytes) {
+        dead -= bytes;
+    }
+
+    inline const void* data() const {
+        return memory;
+    }
+
+    inline bool contains(const void* p) const {
         assert(memory != nullptr);
-        return p >= (void*)memory && p < (void*)(memory + cursor);
+        return p >= (const void*)memory && p < (const void*)(memory + cursor);
     }
 
     inline size_t clauseBytes(size_t length) const {
@@ -201,10 +229,174 @@ private:
 
     std::vector<ClauseAllocatorPage> pages;
     std::vector<ClauseAllocatorPage> phase_out_pages;
+    std::vector<std::pair<const void*, uint32_t>> index; // begin and position of pages, sorted by address
+    std::vector<std::pair<const void*, uint32_t>> phase_out_index; // the same for phase-out pages
+
+    // deleted clauses by length, their memory is reused for new clauses
+    std::vector<std::vector<Clause*>> free_lists;
+    std::vector<uint64_t> occupied; // bitmap of non-empty free lists
+    std::vector<Clause*> released; // deleted since the last call to recycle()
+    size_t free_slots;
+    size_t garbage; // bytes of deleted clauses in pages
+    size_t pending; // bytes of released clauses
+
+    static inline size_t clauseBytes(size_t length) {
+        return (sizeof(Clause) + sizeof(Lit) * (length-1));
+    }
+
+    inline void push_free(Clause* clause) {
+        free_lists[clause->size()].push_back(clause);
+        occupied[clause->size() / 64] |= 1ull << (clause->size() % 64);
+        free_slots++;
+    }
+
+    inline Clause* pop_free(size_t length) {
+        Clause* clause = free_lists[length].back();
+        free_lists[length].pop_back();
+        if (free_lists[length].empty()) occupied[length / 64] &= ~(1ull << (length % 64));
+        free_slots--;
+        return clause;
+    }
+
+    /* smallest length of at least n with a free slot (free_lists.size() if there is none) */
+    inline size_t next_free(size_t n) const {
+        size_t word = n / 64;
+        if (word >= occupied.size()) return free_lists.size();
+        uint64_t bits = occupied[word] & (~0ull << (n % 64));
+        while (bits == 0) {
+            if (++word == occupied.size()) return free_lists.size();
+            bits = occupied[word];
+        }
+        return word * 64 + __builtin_ctzll(bits);
+    }
+
+    /**
+     * Take a free slot of the given length, or split the best fitting slot which is at least four literals 
+     * longer. The tail stays a deleted clause, such that pages can still be iterated.
+     * */
+    inline void* reuse(size_t length) {
+        size_t n = free_lists[length].empty() ? next_free(length + 4) : length;
+        if (n >= free_lists.size()) return nullptr;
+        Clause* slot = pop_free(n);
+        garbage -= clauseBytes(length);
+        page_of(slot)->revive(clauseBytes(length));
+        if (n > length) {
+            Clause* rest = (Clause*)((unsigned char*)slot + clauseBytes(length));
+            rest->length = static_cast<uint16_t>((clauseBytes(n) - clauseBytes(length) - sizeof(Clause)) / sizeof(Lit) + 1);
+            rest->setDeleted();
+            if (rest->length >= 2) push_free(rest);
+        }
+        return slot;
+    }
+
+    /* the page tables have to be sorted again whenever pages are added or removed */
+    static void reindex(const std::vector<ClauseAllocatorPage>& list, std::vector<std::pair<const void*, uint32_t>>& table) {
+        table.clear();
+        for (uint32_t i = 0; i < list.size(); i++) {
+            table.emplace_back(list[i].data(), i);
+        }
+        std::sort(table.begin(), table.end());
+    }
+
+    void reindex() {
+        reindex(pages, index);
+        reindex(phase_out_pages, phase_out_index);
+    }
+
+    /* the page of the list which contains the address, found in its page table */
+    static ClauseAllocatorPage* find_page(std::vector<ClauseAllocatorPage>& list, const std::vector<std::pair<const void*, uint32_t>>& table, const void* p) {
+        auto it = std::upper_bound(table.begin(), table.end(), std::make_pair(p, UINT32_MAX));
+        if (it == table.begin()) return nullptr;
+        ClauseAllocatorPage& page = list[(it-1)->second];
+        return page.contains(p) ? &page : nullptr;
+    }
+
+    inline void add_page(size_t size) {
+        pages.emplace_back(size);
+        reindex(pages, index);
+    }
+
+    inline ClauseAllocatorPage* page_of(const void* p) {
+        return find_page(pages, index, p);
+    }
+
+    /* positions of pages in which more than the given percentage of bytes is deleted (any for 0), most deleted bytes first */
+    std::vector<size_t> fragmented_pages(unsigned int percent, size_t end) const {
+        std::vector<size_t> fragmented;
+        for (size_t i = 0; i < end; i++) {
+            if (pages[i].garbage() > 0 && pages[i].garbage() * 100 > pages[i].used() * percent) {
+                fragmented.push_back(i);
+            }
+        }
+        std::sort(fragmented.begin(), fragmented.end(), [this](size_t i, size_t j) { return pages[i].garbage() > pages[j].garbage(); });
+        return fragmented;
+    }
+
+    /**
+     * Move the selected pages to the phase-out pages and copy their live clauses to the current page. 
+     * The old copies store the new locations (see ClauseForwarding).
+     * */
+    void evacuate_pages(const std::vector<size_t>& selected, ClauseForwarding& forwarding) {
+        std::vector<char> evacuate(pages.size(), false);
+        for (size_t i : selected) evacuate[i] = true;
+        std::vector<ClauseAllocatorPage> kept;
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (evacuate[i]) {
+                phase_out_pages.emplace_back(std::move(pages[i]));
+            } else {
+                kept.emplace_back(std::move(pages[i]));
+            }
+        }
+        pages.swap(kept);
+        reindex();
+        forget_phase_out();
+
+        for (ClauseAllocatorPage& phase_out_page : phase_out_pages) {
+            garbage -= phase_out_page.garbage();
+            forwarding.evacuate(phase_out_page.data(), (const unsigned char*)phase_out_page.data() + phase_out_page.used());
+            for (const Clause* old_clause : phase_out_page) {
+                if (!old_clause->isDeleted()) {
+                    if (pages.empty() || !pages.back().hasMemory(old_clause->size())) {
+                        add_page(default_page_size);
+                    }
+                    void* clause = pages.back().allocate(old_clause->size());
+                    memcpy(clause, (void*)old_clause, phase_out_page.clauseBytes(old_clause->size()));
+                    forwarding.move(const_cast<Clause*>(old_clause), (Clause*)clause);
+                }
+            }
+        }
+    }
+
+    /* drop free slots and released clauses which are located in the phase-out pages */
+    void forget_phase_out() {
+        auto phase_out = [this](Clause* clause) { return phase_out_contains(clause); };
+        for (size_t n = 0; n < free_lists.size(); n++) {
+            if (!free_lists[n].empty()) {
+                size_t before = free_lists[n].size();
+                free_lists[n].erase(std::remove_if(free_lists[n].begin(), free_lists[n].end(), phase_out), free_lists[n].end());
+                free_slots -= before - free_lists[n].size();
+                if (free_lists[n].empty()) occupied[n / 64] &= ~(1ull << (n % 64));
+            }
+        }
+        for (Clause* clause : released) {
+            if (phase_out(clause)) pending -= clauseBytes(clause->size());
+        }
+        released.erase(std::remove_if(released.begin(), released.end(), phase_out), released.end());
+    }
+
+    void clear_free_lists() {
+        for (auto& list : free_lists) list.clear();
+        std::fill(occupied.begin(), occupied.end(), 0);
+        released.clear();
+        free_slots = 0;
+        garbage = 0;
+        pending = 0;
+    }
 
 public:
     ClauseAllocatorMemory(unsigned int page_size_mb = 32)
-     : default_page_size(page_size_mb*1024*1024), pages(), phase_out_pages() { }
+     : default_page_size(page_size_mb*1024*1024), pages(), phase_out_pages(), index(), phase_out_index(), 
+       free_lists(1024), occupied(1024 / 64, 0), released(), free_slots(0), garbage(0), pending(0) { }
     ~ClauseAllocatorMemory() { }
 
     inline const_iterator begin() const {
@@ -217,19 +409,22 @@ public:
     }
 
     inline void* allocate(size_t length) {
+        if (free_slots > 0 && length < free_lists.size()) {
+            void* slot = reuse(length);
+            if (slot != nullptr) return slot;
+        }
         if (pages.size() == 0 || !pages.back().hasMemory(length)) { 
-            pages.emplace_back(default_page_size); 
+            add_page(default_page_size); 
         }
         return pages.back().allocate(length);
     }
 
-    inline bool contains(Clause* clause) {
-        for (ClauseAllocatorPage& page : pages) { 
-            if (page.contains(clause)) {
-                return true;
-            }
-        }
-        return false;
+    inline bool contains(const Clause* clause) {
+        return page_of(clause) != nullptr;
+    }
+
+    inline bool phase_out_contains(Clause* clause) {
+        return find_page(phase_out_pages, phase_out_index, clause) != nullptr;
     }
 
     inline std::vector<Clause*> collect() {
@@ -242,19 +437,64 @@ public:
         return clauses;
     }
 
-    inline size_t used() {
+    inline size_t used() const {
         size_t size = 0;
-        for (ClauseAllocatorPage& page : pages) {
+        for (const ClauseAllocatorPage& page : pages) {
             size += page.used();
         }
         return size;
     }
 
-    void reallocate() {
+    /**
+     * The memory of a deleted clause is only reused after the next call to recycle(), 
+     * when no system holds references to the clause anymore. False if the clause is not located in these pages.
+     * */
+    inline bool release(Clause* clause) {
+        ClauseAllocatorPage* page = page_of(clause);
+        if (page == nullptr) return false;
+        page->discard(clauseBytes(clause->size()));
+        garbage += clauseBytes(clause->size());
+        pending += clauseBytes(clause->size());
+        released.push_back(clause);
+        return true;
+    }
+
+    void recycle() {
+        for (Clause* clause : released) {
+            if (clause->size() >= 2 && clause->size() < free_lists.size()) {
+                push_free(clause);
+            }
+        }
+        released.clear();
+        pending = 0;
+    }
+
+    /**
+     * True if more than the given percentage of the used memory is occupied by deleted clauses which 
+     * were not reused since the previous call to recycle() (always true for 0)
+     * */
+    inline bool fragmented(unsigned int percent) {
+        return percent == 0 || (garbage - pending) * 100 > used() * percent;
+    }
+
+    /**
+     * Copy live clauses to a new page, the given clauses first and in the given order
+     * */
+    void reallocate(const std::vector<Clause*>& order = {}) {
         if (phase_out_pages.empty()) {
             size_t size = used(); 
             phase_out_pages.swap(pages);
-            pages.emplace_back(size);
+            pages.clear();
+            reindex();
+            add_page(size);
+            clear_free_lists();
+            for (Clause* old_clause : order) {
+                if (!old_clause->isDeleted() && phase_out_contains(old_clause)) {
+                    void* clause = allocate(old_clause->size());
+                    memcpy(clause, (void*)old_clause, pages.back().clauseBytes(old_clause->size()));
+                    old_clause->setDeleted(); // skip in the following pass
+                }
+            }
             for (ClauseAllocatorPage& phase_out_page : phase_out_pages) {
                 for (const Clause* old_clause : phase_out_page) {
                     if (!old_clause->isDeleted()) {
@@ -266,13 +506,41 @@ public:
         }
     }
 
+    /**
+     * Move the live clauses of at most the given number of filled pages with the most deleted clauses (more than 
+     * the given percentage of their memory, or any for 0) to the current page, and record their new locations. 
+     * The evacuated pages are released by free_phase_out_pages(), after all references are relocated.
+     * */
+    void evacuate(unsigned int max_pages, unsigned int percent, ClauseForwarding& forwarding) {
+        if (!phase_out_pages.empty() || pages.empty()) return;
+        std::vector<size_t> selected = fragmented_pages(percent, pages.size() - 1); // not the current page
+        if (selected.size() > max_pages) selected.resize(max_pages);
+        if (!selected.empty()) evacuate_pages(selected, forwarding);
+    }
+
+    /**
+     * Copy only the live clauses of fragmented pages (see evacuate()), clauses in all other pages keep their location. 
+     * The memory of deleted clauses in the remaining pages is recycled.
+     * */
+    void compact(unsigned int percent) {
+        if (phase_out_pages.empty()) {
+            ClauseForwarding forwarding;
+            evacuate_pages(fragmented_pages(percent, pages.size()), forwarding);
+            recycle();
+        }
+    }
+
     void free_phase_out_pages() {
         phase_out_pages.clear();
+        phase_out_index.clear();
     }    
     
     void clear() {
         pages.clear();
         phase_out_pages.clear();
+        index.clear();
+        phase_out_index.clear();
+        clear_free_lists();
     }
 
     void import(ClauseAllocatorMemory& other, unsigned int size_limit) {
@@ -281,6 +549,7 @@ public:
                 if (clause->isPersistent() || (!clause->isDeleted() && (size_limit == 0 || clause->size() < size_limit))) {
                     void* new_clause = allocate(clause->size());
                     memcpy(new_clause, (void*)clause, page.clauseBytes(clause->size()));
+                    other.release((Clause*)clause);
                     ((Clause*)clause)->setDeleted(); 
                 }
             }
@@ -292,6 +561,9 @@ public:
             pages.emplace_back(std::move(page));
         }
         other.pages.clear();
+        reindex();
+        garbage += other.garbage; // free lists are not taken over
+        other.clear();
     }
 
 };
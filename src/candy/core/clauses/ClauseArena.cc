@@ -0,0 +1,167 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2020, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include "candy/core/clauses/ClauseArena.h"
+#include "candy/mtl/HugePages.h"
+
+#include <new>
+#include <cstdlib>
+#include <iterator>
+#include <algorithm>
+
+namespace Candy {
+
+const unsigned int ClauseArena::slot_bits;
+const size_t ClauseArena::slot_bytes;
+const size_t ClauseArena::slots;
+const size_t ClauseArena::reservation;
+const size_t ClauseArena::granularity;
+
+std::atomic<char*> ClauseArena::bases[ClauseArena::slots];
+ClauseArena::Arena ClauseArena::arenas[ClauseArena::slots];
+std::atomic<size_t> ClauseArena::count { 0 };
+std::atomic<size_t> ClauseArena::occupied { 0 };
+size_t ClauseArena::next_slot = 0;
+std::mutex ClauseArena::lock;
+
+/**
+ * Reserve an arena of at least the given size in the remaining slots. Virtual memory is reserved in steps of 1 GB 
+ * (less if the address space limit does not permit it), heap memory is allocated as needed.
+ * */
+bool ClauseArena::reserve(size_t bytes) {
+    size_t minimum = (bytes + slot_bytes - 1) / slot_bytes * slot_bytes;
+    size_t available = (slots - next_slot) * slot_bytes;
+    if (minimum > available) return false;
+    size_t size = std::min(std::max(reservation, minimum), available);
+    char* memory = nullptr;
+    bool mapped = false;
+#ifdef CANDY_HAVE_MMAP
+    while (memory == nullptr) {
+        void* mapping = mmap(nullptr, size + granularity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapping != MAP_FAILED) {
+            memory = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(mapping) + granularity - 1) & ~(uintptr_t)(granularity - 1));
+            mapped = true;
+            HugePages::advise(memory, size);
+        }
+        else if (size > minimum) {
+            size = std::max(size / 2, minimum);
+        }
+        else break;
+    }
+#endif
+    if (memory == nullptr) { // fallback
+        size = minimum;
+        void* allocation = std::malloc(size + granularity);
+        if (allocation == nullptr) return false;
+        memory = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(allocation) + granularity - 1) & ~(uintptr_t)(granularity - 1));
+    }
+    size_t n = count.load(std::memory_order_relaxed);
+    Arena& arena = arenas[n];
+    arena.memory = memory;
+    arena.capacity = size;
+    arena.top = 0;
+    arena.slot = static_cast<uint32_t>(next_slot);
+    arena.mapped = mapped;
+    for (size_t offset = 0; offset < size; offset += slot_bytes) {
+        bases[next_slot++].store(memory + offset, std::memory_order_release);
+    }
+    count.store(n + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Replace the range by fresh memory (this returns physical memory, including explicit huge pages)
+ * */
+void ClauseArena::reset(char* memory, size_t bytes) {
+#ifdef CANDY_HAVE_MMAP
+    mmap(memory, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    HugePages::advise(memory, bytes);
+#endif
+}
+
+/**
+ * Back the range by explicit huge pages if requested, the range is reset if the pool is exhausted
+ * */
+void ClauseArena::back(Arena& arena, char* memory, size_t bytes) {
+    if (arena.mapped && SolverOptions::opt_huge_pages == 2 && !HugePages::remap(memory, bytes)) {
+        reset(memory, bytes);
+    }
+}
+
+/**
+ * First fit in the free ranges of the arena, then the unused tail
+ * */
+void* ClauseArena::take(Arena& arena, size_t bytes) {
+    for (auto it = arena.released.begin(); it != arena.released.end(); it++) {
+        if (it->second >= bytes) {
+            size_t offset = it->first;
+            if (it->second > bytes) arena.released.emplace(offset + bytes, it->second - bytes);
+            arena.released.erase(it);
+            back(arena, arena.memory + offset, bytes);
+            return arena.memory + offset;
+        }
+    }
+    if (arena.top + bytes <= arena.capacity) {
+        arena.top += bytes;
+        back(arena, arena.memory + arena.top - bytes, bytes);
+        return arena.memory + arena.top - bytes;
+    }
+    return nullptr;
+}
+
+void* ClauseArena::acquire(size_t bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    bytes = (std::max<size_t>(bytes, 1) + granularity - 1) / granularity * granularity;
+    size_t n = count.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < n; i++) {
+        void* memory = take(arenas[i], bytes);
+        if (memory != nullptr) return memory;
+    }
+    if (!reserve(bytes)) {
+        throw std::bad_alloc();
+    }
+    return take(arenas[n], bytes);
+}
+
+void ClauseArena::release(void* memory, size_t bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    bytes = (std::max<size_t>(bytes, 1) + granularity - 1) / granularity * granularity;
+    size_t n = count.load(std::memory_order_relaxed);
+    Arena* owner = nullptr;
+    for (size_t i = 0; i < n && owner == nullptr; i++) {
+        if (memory >= arenas[i].memory && memory < arenas[i].memory + arenas[i].capacity) owner = &arenas[i];
+    }
+    if (owner == nullptr) return;
+    Arena& arena = *owner;
+    if (arena.mapped) reset(static_cast<char*>(memory), bytes);
+    size_t offset = static_cast<char*>(memory) - arena.memory;
+    auto next = arena.released.lower_bound(offset);
+    if (next != arena.released.end() && next->first == offset + bytes) { // merge with successor
+        bytes += next->second;
+        next = arena.released.erase(next);
+    }
+    if (next != arena.released.begin() && std::prev(next)->first + std::prev(next)->second == offset) { // merge with predecessor
+        std::prev(next)->second += bytes;
+    }
+    else {
+        arena.released.emplace(offset, bytes);
+    }
+}
+
+}
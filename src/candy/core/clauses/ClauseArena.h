@@ -0,0 +1,118 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2020, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_CANDY_CORE_CLAUSEARENA_H_
+#define SRC_CANDY_CORE_CLAUSEARENA_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace Candy {
+
+class Clause;
+
+/**
+ * class ClauseArena:
+ * 
+ *  The pages of all clause allocators are carved from arenas, such that a clause is addressed by a 32-bit reference. 
+ *  The reference space (16 GB in 4-byte words) is divided into slots of 64 MB, the upper bits of a reference select 
+ *  the slot and the lower bits are the word offset from its base. Clauses of the global allocator are shared by 
+ *  the solvers, hence all allocators use the same reference space. 
+ *  Arenas are reserved on demand (1 GB at a time, physical memory is committed on first use) and occupy consecutive 
+ *  slots. Where virtual memory cannot be reserved, arenas are allocated from the heap. 
+ *  Pages are backed by transparent or explicit huge pages depending on the huge-pages option.
+ * 
+ * */
+class ClauseArena {
+private:
+    struct Arena {
+        char* memory;
+        size_t capacity;
+        size_t top;
+        uint32_t slot; // first slot
+        bool mapped; // reserved virtual memory, otherwise heap memory
+        std::map<size_t, size_t> released; // free ranges by offset
+    };
+
+    static const unsigned int slot_bits = 24; // words per slot
+    static const size_t slot_bytes = size_t(4) << slot_bits;
+    static const size_t slots = size_t(1) << (32 - slot_bits);
+    static const size_t reservation = size_t(1) << 30;
+
+    static std::atomic<char*> bases[slots];
+    static Arena arenas[slots];
+    static std::atomic<size_t> count; // arenas
+    static std::atomic<size_t> occupied; // bytes of clauses in pages
+    static size_t next_slot;
+    static std::mutex lock;
+
+    static bool reserve(size_t bytes);
+    static void* take(Arena& arena, size_t bytes);
+    static void reset(char* memory, size_t bytes);
+    static void back(Arena& arena, char* memory, size_t bytes);
+
+public:
+    static const size_t granularity = 2 * 1024 * 1024; // huge page size
+
+    /* memory for a page of the given size (rounded up to the granularity), throws std::bad_alloc if the reference space is exhausted */
+    static void* acquire(size_t bytes);
+
+    /* give back the memory of a page, physical memory is returned to the system if the arena is reserved virtual memory */
+    static void release(void* memory, size_t bytes);
+
+    /* bytes of clauses in the pages of all allocators, deleted clauses included until their page is reset or released */
+    static inline size_t used() {
+        return occupied.load(std::memory_order_relaxed);
+    }
+
+    static inline void occupy(size_t bytes) {
+        occupied.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    static inline void vacate(size_t bytes) {
+        occupied.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    static inline uint32_t ref(const Clause* clause) {
+        const char* memory = reinterpret_cast<const char*>(clause);
+        size_t n = count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; i++) {
+            if (memory >= arenas[i].memory && memory < arenas[i].memory + arenas[i].capacity) {
+                return (arenas[i].slot << slot_bits) + static_cast<uint32_t>((memory - arenas[i].memory) >> 2);
+            }
+        }
+        return UINT32_MAX;
+    }
+
+    static inline Clause* clause(uint32_t ref) {
+        return reinterpret_cast<Clause*>(bases[ref >> slot_bits].load(std::memory_order_relaxed) + (static_cast<size_t>(ref & ((1u << slot_bits) - 1)) << 2));
+    }
+
+    static inline bool contains(const void* memory) {
+        return ref(static_cast<const Clause*>(memory)) != UINT32_MAX;
+    }
+
+};
+
+}
+
+#endif
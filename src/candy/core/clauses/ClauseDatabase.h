@@ -27,6 +27,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/clauses/Clause.h"
 #include "candy/core/clauses/ClauseAllocator.h"
 #include "candy/core/clauses/Certificate.h"
+#include "candy/core/clauses/Antecedents.h"
+#include "candy/core/clauses/ClauseMetadata.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/clauses/BinaryClauses.h"
 #include "candy/core/clauses/Equivalences.h"
 #include "candy/core/Trail.h"
@@ -41,12 +44,13 @@ namespace Candy {
 
 struct AnalysisResult {
 	AnalysisResult() : 
-		nConflicts(0), learnt_clause(), involved_clauses(), lbd(0), backtrack_level(0)
+		nConflicts(0), learnt_clause(), involved_clauses(), hints(), lbd(0), backtrack_level(0)
 	{ }
 
 	uint64_t nConflicts;
 	std::vector<Lit> learnt_clause;
 	std::vector<Reason> involved_clauses;
+	std::vector<uint32_t> hints; // antecedent ids of the learnt clause (LRAT)
 	unsigned int lbd;
     unsigned int backtrack_level;
 
@@ -71,7 +75,12 @@ private:
 
     Certificate certificate;
 
+    ClauseForwarding forwarding; // new locations of the clauses of the last evacuated pages
+
 public:
+    Antecedents antecedents;
+    ClauseMetadata metadata;
+
     std::vector<double> occurrence;
 
     std::vector<Lit> unaries;
@@ -83,13 +92,37 @@ public:
 
     ClauseDatabase(CNFProblem& problem) : 
         allocator(), variables(problem.nVars()), clauses(), emptyClause_(false), 
-        certificate(SolverOptions::opt_certified_file), 
-        occurrence(2 * problem.nVars(), 0.0),
+        certificate(SolverOptions::opt_certified_file, SolverOptions::opt_certified_binary, SolverOptions::opt_certified_async, SolverOptions::opt_certified_lrat), 
+        forwarding(), antecedents(certificate, problem.nVars()), metadata(), occurrence(2 * problem.nVars(), 0.0),
         unaries(), binaries(problem.nVars()), result(), equiv(binaries)
     { 
-        for (Cl* import : problem) {
-            createClause(import->begin(), import->end(), 0, true);
+        // the ids of the problem clauses are their positions in the input (skipping dropped tautologies)
+        const std::vector<uint64_t>& dropped = problem.droppedClauses();
+        uint32_t position = 0;
+        size_t skipped = 0;
+        auto advance = [this, &dropped, &position, &skipped]() {
+            for (; skipped < dropped.size() && dropped[skipped] == position; skipped++) position++;
+            antecedents.advance(++position);
+        };
+        if (problem.isStreamed()) {
+            problem.streamClauses([this, &problem, &advance](Lit* begin, Lit* end) {
+                if (problem.nVars() > variables) {
+                    variables = problem.nVars();
+                    occurrence.resize(2 * variables, 0.0);
+                    binaries.grow(variables);
+                    antecedents.grow(variables);
+                }
+                advance();
+                createClause(begin, end, 0, true);
+            });
+        }
+        else {
+            for (CNFClause import : problem) {
+                advance();
+                createClause(import.begin(), import.end(), 0, true);
+            }
         }
+        antecedents.advance(position + (dropped.size() - skipped) + 1);
     }
 
     ~ClauseDatabase() { }
@@ -105,6 +138,7 @@ public:
     void setGlobalClauseAllocator(ClauseAllocator* global_allocator) {
         allocator.set_global_allocator(global_allocator);
         this->clauses = allocator.collect();
+        metadata.rebuild(clauses, false);
         unaries.clear();
         binaries.clear();
         for (Clause* clause : clauses) {
@@ -116,10 +150,20 @@ public:
         }
     }
 
-    void reorganize() {
+    /**
+     * Compact the pages which are fragmented by deleted clauses once enough memory is occupied by them, 
+     * otherwise make their memory available for new clauses. References to clauses are invalid afterwards. 
+     * If the order of the next assignments is given (e.g. the last trail), the long clauses are relocated 
+     * in the order in which propagation visits their watch lists, such that clauses which are watched 
+     * together are adjacent in memory. With compact set, the memory of deleted clauses is returned regardless 
+     * of the fragmentation.
+     * */
+    void reorganize(const std::vector<Lit>& order = {}, bool compact = false) {
         allocator.synchronize(); // inactive if no global-allocator
-        allocator.reorganize(); // defrag.
+        allocator.reorganize(compact || allocator.fragmented() ? arrange(order) : std::vector<Clause*>(), compact); // defrag. or recycle
         clauses = allocator.collect();
+        uint32_t next_id = metadata.rebuild(clauses, !antecedents.active());
+        if (!antecedents.active()) antecedents.rewind(next_id);
         unaries.clear();
         binaries.clear();
         for (Clause* clause : clauses) {
@@ -131,6 +175,93 @@ public:
         }
     }
 
+    /**
+     * Incremental alternative to reorganize(), no memory is moved and no reference is invalidated: 
+     * deleted clauses are dropped from the working set. The next defragment() drops all references to them, 
+     * their memory is evacuated or reused after release_evacuated().
+     * */
+    void sweep() {
+        bool small = false;
+        auto deleted = [&small](Clause* clause) { 
+            if (clause->isDeleted()) small |= clause->size() <= 2; 
+            return clause->isDeleted(); 
+        };
+        clauses.erase(std::remove_if(clauses.begin(), clauses.end(), deleted), clauses.end());
+        uint32_t next_id = metadata.rebuild(clauses, !antecedents.active());
+        if (!antecedents.active()) antecedents.rewind(next_id);
+        if (small) {
+            unaries.clear();
+            binaries.clear();
+            for (Clause* clause : clauses) {
+                if (clause->size() == 1) {
+                    unaries.push_back(clause->first());
+                } else if (clause->size() == 2) {
+                    binaries.add(clause);
+                }
+            }
+        }
+        forwarding.sweep();
+    }
+
+    /**
+     * Evacuate at most the given number of pages with deleted clauses. The returned table holds the new 
+     * locations of the moved clauses, all other references to clauses have to be relocated before 
+     * release_evacuated() frees the evacuated pages. References to deleted clauses do not survive relocation.
+     * */
+    const ClauseForwarding& defragment(unsigned int max_pages) {
+        allocator.evacuate(max_pages, forwarding);
+        if (!forwarding.empty()) {
+            forwarding.relocate(clauses, [](Clause*& clause) -> Clause*& { return clause; });
+            metadata.relocate(forwarding);
+        }
+        return forwarding;
+    }
+
+    void release_evacuated() {
+        allocator.release_evacuated();
+        if (forwarding.swept()) allocator.recycle(); // no references to deleted clauses are left
+        forwarding.clear();
+    }
+
+    /**
+     * Long clauses by their watched literals (the first two), visiting the watch list of ~lit for each lit in order
+     * */
+    std::vector<Clause*> arrange(const std::vector<Lit>& order) {
+        std::vector<Clause*> arranged;
+        if (order.empty()) return arranged;
+
+        std::vector<uint32_t> offsets(2 * variables + 1, 0);
+        for (Clause* clause : clauses) {
+            if (clause->size() > 2 && !clause->isDeleted()) {
+                offsets[clause->first()]++;
+                offsets[clause->second()]++;
+            }
+        }
+        for (size_t i = 1; i < offsets.size(); i++) offsets[i] += offsets[i-1];
+        std::vector<uint32_t> watched(offsets.back());
+        for (uint32_t i = clauses.size(); i-- > 0; ) {
+            Clause* clause = clauses[i];
+            if (clause->size() > 2 && !clause->isDeleted()) {
+                watched[--offsets[clause->first()]] = i;
+                watched[--offsets[clause->second()]] = i;
+            }
+        }
+
+        std::vector<char> placed(clauses.size(), false);
+        arranged.reserve(watched.size() / 2);
+        for (Lit lit : order) {
+            if ((unsigned int)lit.var() >= variables) continue;
+            Lit falsified = ~lit;
+            for (uint32_t k = offsets[falsified]; k < offsets[falsified+1]; k++) {
+                if (!placed[watched[k]]) {
+                    placed[watched[k]] = true;
+                    arranged.push_back(clauses[watched[k]]);
+                }
+            }
+        }
+        return arranged;
+    }
+
     typedef std::vector<Clause*>::const_iterator const_iterator;
 
     inline const_iterator begin() const {
@@ -163,20 +294,42 @@ public:
         return emptyClause_;
     }
 
-    void emptyClause() {
-        emptyClause_ = true;
-        certificate.proof();
+    void emptyClause(const std::vector<uint32_t>& hints = {}) {
+        if (!emptyClause_) {
+            emptyClause_ = true;
+            certificate.proof(antecedents.next(), hints);
+        }
+    }
+
+    /* derive the empty clause from a conflict at level 0 */
+    void refute(Trail& trail, Reason conflict) {
+        std::vector<uint32_t> hints;
+        antecedents.derive(trail, (Lit*)nullptr, (Lit*)nullptr, conflict, hints);
+        emptyClause(hints);
+    }
+
+    /* derive the empty clause from a unit clause which is falsified at level 0 */
+    void refute(Trail& trail, Lit unit) {
+        std::vector<uint32_t> hints;
+        if (antecedents.active()) {
+            hints = { antecedents.unit(trail, unit.var()), antecedents.unit(unit) };
+            if (hints.front() == 0 || hints.back() == 0) hints.clear();
+        }
+        emptyClause(hints);
     }
 
     template<typename Iterator>
-    inline Clause* createClause(Iterator begin, Iterator end, unsigned int lbd = 0, bool lemma = false) {
+    inline Clause* createClause(Iterator begin, Iterator end, unsigned int lbd = 0, bool lemma = false, const std::vector<uint32_t>& hints = {}) {
         unsigned int length = std::distance(begin, end);
         unsigned int weight = length < 3 ? 0 : lbd;
 
         Clause* clause = new (allocator.allocate(length, weight)) Clause(begin, end, weight);
+        clause->identifier = antecedents.next();
         clauses.push_back(clause);
+        antecedents.add(clause);
+        metadata.add(clause);
 
-        if (!lemma) certificate.added(clause->begin(), clause->end());
+        if (!lemma) certificate.added(clause->begin(), clause->end(), clause->id(), hints);
 
         if (clause->size() == 0) {
             emptyClause_ = true;
@@ -195,20 +348,24 @@ public:
         return clause;
     }
 
-    inline void removeClause(Clause* clause) {
+    /* the deletion is not certified for clauses which might be restored (e.g. eliminated clauses in LRAT mode) */
+    inline void removeClause(Clause* clause, bool certify = true) {
+        metadata.remove(clause);
         allocator.deallocate(clause);
-        certificate.removed(clause->begin(), clause->end());
+        antecedents.remove(clause);
+        if (certify) certificate.removed(clause->begin(), clause->end(), clause->id());
 
         for (Lit lit : *clause) {
             occurrence[lit] -= 1.0 / pow(2, clause->size());
         }
     }
 
-    Clause* strengthenClause(Clause* clause, Lit lit) {
+    /* remove the literal from the clause, the hints (LRAT) derive the strengthened clause */
+    Clause* strengthenClause(Clause* clause, Lit lit, const std::vector<uint32_t>& hints = {}) {
         assert(clause->size() > 1);
         std::vector<Lit> literals;
         for (Lit literal : *clause) if (literal != lit) literals.push_back(literal);
-        Clause* new_clause = createClause(literals.begin(), literals.end(), std::min((uint16_t)clause->getLBD(), (uint16_t)literals.size()));
+        Clause* new_clause = createClause(literals.begin(), literals.end(), std::min((uint16_t)clause->getLBD(), (uint16_t)literals.size()), false, hints);
         removeClause(clause);
         return new_clause;
     }
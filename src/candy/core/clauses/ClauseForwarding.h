@@ -0,0 +1,115 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2020, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_CANDY_CORE_CLAUSE_FORWARDING_H_
+#define SRC_CANDY_CORE_CLAUSE_FORWARDING_H_
+
+#include <vector>
+#include <algorithm>
+
+#include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseArena.h"
+
+namespace Candy {
+
+/**
+ * Forwarding of references into evacuated pages. The old copy of each moved clause stays readable until 
+ * the evacuated pages are released and stores the reference to its new location, such that systems which 
+ * hold references to clauses can relocate them in a single pass. References to deleted clauses are dropped, 
+ * after a sweep also those into the remaining pages (afterwards their memory can be reused).
+ * */
+class ClauseForwarding {
+private:
+    std::vector<std::pair<uint32_t, uint32_t>> ranges; // evacuated pages [begin, end), sorted
+    bool sweeping;
+
+public:
+    ClauseForwarding() : ranges(), sweeping(false) { }
+
+    inline bool empty() const {
+        return ranges.empty() && !sweeping;
+    }
+
+    void clear() {
+        ranges.clear();
+        sweeping = false;
+    }
+
+    /* drop the references to deleted clauses in all pages */
+    void sweep() {
+        sweeping = true;
+    }
+
+    inline bool swept() const {
+        return sweeping;
+    }
+
+    void evacuate(const void* begin, const void* end) {
+        std::pair<uint32_t, uint32_t> range { ClauseArena::ref((const Clause*)begin), ClauseArena::ref((const Clause*)end) };
+        ranges.insert(std::upper_bound(ranges.begin(), ranges.end(), range), range);
+    }
+
+    /* the old copy is not used anymore, its id field holds the new reference */
+    inline void move(Clause* from, const Clause* to) {
+        from->identifier = ClauseArena::ref(to);
+    }
+
+    inline bool evacuated(uint32_t cref) const {
+        auto it = std::upper_bound(ranges.begin(), ranges.end(), std::make_pair(cref, UINT32_MAX));
+        return it != ranges.begin() && cref < (it-1)->second;
+    }
+
+    /* update the reference, false if the referenced clause was deleted (the reference stays unchanged then) */
+    inline bool relocate(uint32_t& cref) const {
+        if (evacuated(cref)) {
+            const Clause* old = ClauseArena::clause(cref);
+            if (old->isDeleted()) return false;
+            cref = old->identifier;
+        }
+        else if (sweeping && ClauseArena::clause(cref)->isDeleted()) {
+            return false;
+        }
+        return true;
+    }
+
+    inline bool relocate(Clause*& clause) const {
+        uint32_t cref = ClauseArena::ref(clause);
+        if (!relocate(cref)) return false;
+        clause = ClauseArena::clause(cref);
+        return true;
+    }
+
+    /* relocate the references in a list, and drop those to deleted clauses */
+    template<typename List, typename Reference>
+    void relocate(List& list, Reference reference) const {
+        auto keep = list.begin();
+        for (auto it = list.begin(); it != list.end(); it++) {
+            if (relocate(reference(*it))) {
+                *keep = *it;
+                keep++;
+            }
+        }
+        list.erase(keep, list.end());
+    }
+
+};
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2020, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_CANDY_CORE_CLAUSE_METADATA_H_
+#define SRC_CANDY_CORE_CLAUSE_METADATA_H_
+
+#include <vector>
+
+#include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseArena.h"
+#include "candy/core/clauses/ClauseForwarding.h"
+#include "candy/mtl/HugePages.h"
+#include "candy/utils/CLIOptions.h"
+
+namespace Candy {
+
+/**
+ * Mutable metadata of learnt clauses (lbd, usage counter, deleted bit and tier) in dense arrays 
+ * indexed by clause id. Reduction scans these arrays instead of the clause headers spread across 
+ * the arena. The lbd is mirrored in the clause header, which stays authoritative for all other systems. 
+ * */
+class ClauseMetadata {
+private:
+    enum : uint8_t { USED = 3, DELETED = 4 };
+
+    const unsigned int persistentLBD;
+    const unsigned int volatileLBD;
+
+    HugePageVector<uint8_t> lbds;
+    HugePageVector<uint8_t> states; // bits 0-1: used, bit 2: deleted, bits 3-4: tier
+    HugePageVector<uint32_t> refs; // arena reference by id
+    HugePageVector<uint32_t> learnts; // ids of learnt clauses
+
+    inline uint8_t tier_of(unsigned int lbd) const {
+        return lbd <= persistentLBD ? CORE : (lbd < volatileLBD ? TIER2 : LOCAL);
+    }
+
+    inline void set(uint32_t id, Clause* clause, uint8_t used) {
+        if (id >= states.size()) {
+            lbds.resize(id + 1, 0);
+            states.resize(id + 1, DELETED);
+            refs.resize(id + 1, 0);
+        }
+        lbds[id] = clause->getLBD();
+        states[id] = used | (tier_of(clause->getLBD()) << 3);
+        refs[id] = ClauseArena::ref(clause);
+        learnts.push_back(id);
+    }
+
+public:
+    enum : uint8_t { CORE = 0, TIER2 = 1, LOCAL = 2 };
+
+    ClauseMetadata() : 
+        persistentLBD(ClauseDatabaseOptions::opt_persistent_lbd), 
+        volatileLBD(ClauseDatabaseOptions::opt_volatile_lbd), 
+        lbds(), states(), refs(), learnts() 
+    { }
+
+    typedef HugePageVector<uint32_t>::const_iterator const_iterator;
+
+    inline const_iterator begin() const {
+        return learnts.begin();
+    }
+
+    inline const_iterator end() const {
+        return learnts.end();
+    }
+
+    void add(Clause* clause) {
+        if (clause->isLearnt()) {
+            set(clause->id(), clause, 2);
+        }
+    }
+
+    void remove(const Clause* clause) {
+        if (clause->isLearnt() && !clause->isDeleted()) {
+            states[clause->id()] |= DELETED;
+        }
+    }
+
+    /* new lbd of a learnt clause involved in a conflict */
+    inline void update(Clause* clause, uint8_t lbd) {
+        uint32_t id = clause->id();
+        clause->setLBD(lbd);
+        lbds[id] = lbd;
+        uint8_t used = states[id] & USED;
+        states[id] = (used < 3 ? used + 1 : used) | (tier_of(lbd) << 3);
+    }
+
+    inline uint8_t decUsed(uint32_t id) {
+        uint8_t used = states[id] & USED;
+        if (used > 0) states[id]--;
+        return used > 0 ? used - 1 : 0;
+    }
+
+    inline uint8_t lbd(uint32_t id) const {
+        return lbds[id];
+    }
+
+    inline uint8_t tier(uint32_t id) const {
+        return states[id] >> 3;
+    }
+
+    inline bool isDeleted(uint32_t id) const {
+        return states[id] & DELETED;
+    }
+
+    inline Clause* clause(uint32_t id) const {
+        return ClauseArena::clause(refs[id]);
+    }
+
+    /* follow the learnt clauses of evacuated pages */
+    void relocate(const ClauseForwarding& forwarding) {
+        for (uint32_t id : learnts) {
+            if (!forwarding.relocate(refs[id])) states[id] |= DELETED;
+        }
+    }
+
+    /**
+     * Rebuild the table from the live clauses after they were relocated. If ids are not referenced 
+     * otherwise (no LRAT), the learnt clauses are numbered densely from 1 and the next free id is returned.
+     * */
+    uint32_t rebuild(const std::vector<Clause*>& clauses, bool renumber) {
+        HugePageVector<uint8_t> previous;
+        previous.swap(states);
+        lbds.clear();
+        refs.clear();
+        learnts.clear();
+        for (Clause* clause : clauses) {
+            if (clause->isLearnt()) {
+                uint8_t used = clause->id() < previous.size() ? previous[clause->id()] & USED : 2;
+                if (renumber) clause->identifier = learnts.size() + 1;
+                set(clause->id(), clause, used);
+            }
+        }
+        return learnts.size() + 1;
+    }
+
+};
+
+}
+
+#endif
@@ -23,22 +23,28 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseArena.h"
+#include "candy/mtl/HugePages.h"
 
 namespace Candy {
 
 template<unsigned int N>
 struct Occurrence {
     Lit others[N-1];
-    Clause* clause;
+    uint32_t cref; // arena-relative clause reference
 
-    Occurrence(Clause* clause_, Lit occ) : clause(clause_) { 
+    Occurrence(Clause* clause_, Lit occ) : cref(ClauseArena::ref(clause_)) { 
         unsigned int i = 0;
-        for (Lit lit : *clause) {
+        for (Lit lit : *clause_) {
             if (lit != occ) others[i++] = lit;
         }
         assert(i == N-1);
     }
 
+    inline Clause* clause() const {
+        return ClauseArena::clause(cref);
+    }
+
     typedef Lit* iterator;
 
     inline iterator begin() {
@@ -54,17 +60,17 @@ struct Occurrence {
 template<unsigned int N>
 class NaryClauses {
 public:
-    std::vector<std::vector<Occurrence<N>>> lists;
+    std::vector<HugePageVector<Occurrence<N>>> lists;
 
     NaryClauses(unsigned int nVars) : lists() {
         lists.resize(2*nVars);
     }
 
     void clear() {
-        for (std::vector<Occurrence<N>>& occ : lists) occ.clear();
+        for (HugePageVector<Occurrence<N>>& occ : lists) occ.clear();
     }
 
-    inline std::vector<Occurrence<N>>& operator [](Lit p) {
+    inline HugePageVector<Occurrence<N>>& operator [](Lit p) {
         return lists[p];
     }
 
@@ -78,7 +84,7 @@ public:
     void remove(Clause* clause) {
         assert(clause->size() == N);
         for (const Lit lit : *clause) {
-            lists[~lit].erase(std::find_if(lists[~lit].begin(), lists[~lit].end(), [clause](Occurrence<N> o) { return o.clause == clause; }));
+            lists[~lit].erase(std::find_if(lists[~lit].begin(), lists[~lit].end(), [clause](Occurrence<N> o) { return o.clause() == clause; }));
         }
     }
 
@@ -272,6 +272,10 @@ public:
 		}
 
 		clause_db.result.setLearntClause(learnt_clause, involved_clauses, lbd, backtrack_level); 
+
+		if (clause_db.antecedents.active()) {
+			clause_db.antecedents.derive(trail, clause_db.result.learnt_clause.begin(), clause_db.result.learnt_clause.end(), confl, clause_db.result.hints);
+		}
 	}
 
 };
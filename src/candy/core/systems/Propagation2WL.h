@@ -44,6 +44,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/ClauseDatabase.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseArena.h"
+#include "candy/core/clauses/ClauseForwarding.h"
+#include "candy/mtl/HugePages.h"
+#include "candy/mtl/Memory.h"
 #include "candy/core/Trail.h"
 #include "candy/core/systems/PropagationInterface.h"
 #include <array>
@@ -51,19 +55,28 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 namespace Candy {
 
 struct Watcher {
-    Clause* cref;
+    uint32_t cref; // arena-relative clause reference, a watcher fits in 8 bytes
     Lit blocker;
 
     Watcher(Clause* cr, Lit p)
-     : cref(cr), blocker(p) { }
+     : cref(ClauseArena::ref(cr)), blocker(p) { }
+
+    Watcher(uint32_t cref_, Lit p)
+     : cref(cref_), blocker(p) { }
+
+    inline Clause* clause() const {
+        return ClauseArena::clause(cref);
+    }
 };
 
+typedef std::vector<Watcher, HugePageAllocator<Watcher>> WatchList;
+
 class Propagation2WL : public PropagationInterface {
 private:
     ClauseDatabase& clause_db;
     Trail& trail;
 
-    std::vector<std::vector<Watcher>> watchers;
+    std::vector<WatchList> watchers;
 
 public:
     Propagation2WL(ClauseDatabase& _clause_db, Trail& _trail)
@@ -86,6 +99,16 @@ public:
         }
     }
 
+    void relocate(const ClauseForwarding& forwarding) override {
+        for (WatchList& list : watchers) {
+            forwarding.relocate(list, [](Watcher& w) -> uint32_t& { return w.cref; });
+        }
+    }
+
+    void shrink() override {
+        shrink_lists(watchers);
+    }
+
     void attachClause(Clause* clause) override {
         assert(clause->size() > 2);
         watchers[~clause->first()].emplace_back(clause, clause->second());
@@ -94,10 +117,10 @@ public:
 
     void detachClause(Clause* clause) override {
         assert(clause->size() > 2);
-        std::vector<Watcher>& list0 = watchers[~clause->first()];
-        std::vector<Watcher>& list1 = watchers[~clause->second()];
-        list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.cref == clause; }), list0.end());
-        list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.cref == clause; }), list1.end());
+        WatchList& list0 = watchers[~clause->first()];
+        WatchList& list1 = watchers[~clause->second()];
+        list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.clause() == clause; }), list0.end());
+        list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.clause() == clause; }), list1.end());
     }
 
     inline Reason propagate_binary_clauses(Lit p) {
@@ -125,14 +148,14 @@ public:
      *      * the propagation queue is empty, even if there was a conflict.
      **************************************************************************************************/
     Reason propagate_watched_clauses(Lit p) {
-        std::vector<Watcher>& list = watchers[p];
+        WatchList& list = watchers[p];
 
         auto keep = list.begin();
         for (auto watcher = list.begin(); watcher != list.end(); watcher++) {
             lbool val = trail.value(watcher->blocker);
 
             if (val != l_True) { // Try to avoid inspecting the clause
-                Clause* clause = watcher->cref;
+                Clause* clause = watcher->clause();
 
                 if (clause->isDeleted()) continue;
 
@@ -149,7 +172,7 @@ public:
                     for (uint_fast16_t k = 2; k < clause->size(); k++) {
                         if (trail.value((*clause)[k]) != l_False) {
                             clause->swap(1, k);
-                            watchers[~clause->second()].emplace_back(clause, clause->first());
+                            watchers[~clause->second()].emplace_back(watcher->cref, clause->first());
                             goto propagate_skip;
                         }
                     }
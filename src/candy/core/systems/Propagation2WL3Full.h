@@ -44,7 +44,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/ClauseDatabase.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/clauses/NaryClauses.h"
+#include "candy/mtl/HugePages.h"
+#include "candy/mtl/Memory.h"
 #include "candy/core/Trail.h"
 #include "candy/core/systems/PropagationInterface.h"
 
@@ -52,20 +55,30 @@ namespace Candy {
 
 struct WatchX {
     Lit blocker[2];
-    Clause* clause;
+    uint32_t cref; // arena-relative clause reference
 
-    WatchX(Clause* clause_, Lit lit1, Lit lit2) : clause(clause_) { 
+    WatchX(Clause* clause_, Lit lit1, Lit lit2) : cref(ClauseArena::ref(clause_)) { 
         blocker[0] = lit1; blocker[1] = lit2;
     }
 
+    inline Clause* clause() const {
+        return ClauseArena::clause(cref);
+    }
+
     WatchX(Clause* clause_, Lit lit) : WatchX(clause_, lit, lit_Undef) { }
+
+    WatchX(uint32_t cref_, Lit lit) : cref(cref_) { 
+        blocker[0] = lit; blocker[1] = lit_Undef;
+    }
 };
 
+typedef std::vector<WatchX, HugePageAllocator<WatchX>> WatchXList;
+
 inline std::ostream& operator <<(std::ostream& stream, WatchX const& reason) {
     if (reason.blocker[1] != lit_Undef) {
         stream << reason.blocker[0] << " " << reason.blocker[1];
     } else {
-        stream << *reason.clause;
+        stream << *reason.clause();
     }
     return stream;
 }
@@ -75,8 +88,8 @@ private:
     ClauseDatabase& clause_db;
     Trail& trail;
 
-    std::vector<std::vector<WatchX>> watchers;
-    std::vector<std::vector<WatchX>> full;
+    std::vector<WatchXList> watchers;
+    std::vector<WatchXList> full;
 
 public:
     Propagation2WL3Full(ClauseDatabase& _clause_db, Trail& _trail) : 
@@ -101,6 +114,20 @@ public:
         }
     }
 
+    void relocate(const ClauseForwarding& forwarding) override {
+        for (WatchXList& list : watchers) {
+            forwarding.relocate(list, [](WatchX& w) -> uint32_t& { return w.cref; });
+        }
+        for (WatchXList& list : full) {
+            forwarding.relocate(list, [](WatchX& w) -> uint32_t& { return w.cref; });
+        }
+    }
+
+    void shrink() override {
+        shrink_lists(watchers);
+        shrink_lists(full);
+    }
+
     void attachClause(Clause* clause) override {
         assert(clause->size() > 2);
         if (clause->size() == 3) {
@@ -117,18 +144,18 @@ public:
     void detachClause(Clause* clause) override {
         assert(clause->size() > 2);
         if (clause->size() == 3) {
-            std::vector<WatchX>& list0 = full[~clause->first()];
-            std::vector<WatchX>& list1 = full[~clause->second()];
-            std::vector<WatchX>& list2 = full[~clause->third()];
-            list0.erase(std::find_if(list0.begin(), list0.end(), [clause](WatchX w) { return w.clause == clause; }));
-            list1.erase(std::find_if(list1.begin(), list1.end(), [clause](WatchX w) { return w.clause == clause; }));
-            list2.erase(std::find_if(list2.begin(), list2.end(), [clause](WatchX w) { return w.clause == clause; }));
+            WatchXList& list0 = full[~clause->first()];
+            WatchXList& list1 = full[~clause->second()];
+            WatchXList& list2 = full[~clause->third()];
+            list0.erase(std::find_if(list0.begin(), list0.end(), [clause](WatchX w) { return w.clause() == clause; }));
+            list1.erase(std::find_if(list1.begin(), list1.end(), [clause](WatchX w) { return w.clause() == clause; }));
+            list2.erase(std::find_if(list2.begin(), list2.end(), [clause](WatchX w) { return w.clause() == clause; }));
         } 
         else {
-            std::vector<WatchX>& list0 = watchers[~clause->first()];
-            std::vector<WatchX>& list1 = watchers[~clause->second()];
-            list0.erase(std::find_if(list0.begin(), list0.end(), [clause](WatchX w) { return w.clause == clause; }));
-            list1.erase(std::find_if(list1.begin(), list1.end(), [clause](WatchX w) { return w.clause == clause; }));
+            WatchXList& list0 = watchers[~clause->first()];
+            WatchXList& list1 = watchers[~clause->second()];
+            list0.erase(std::find_if(list0.begin(), list0.end(), [clause](WatchX w) { return w.clause() == clause; }));
+            list1.erase(std::find_if(list1.begin(), list1.end(), [clause](WatchX w) { return w.clause() == clause; }));
         }
     }
 
@@ -153,16 +180,18 @@ public:
                 lbool val1 = trail.value(watcher.blocker[1]);
 
                 if ((val0 | val1) == 3) { // propagate
+                    if (watcher.clause()->isDeleted()) continue; // dropped by relocate() or reset()
                     // if (val1 == l_False) {
-                    //     trail.propagate(watcher.blocker[0], Reason(watcher.clause));
+                    //     trail.propagate(watcher.blocker[0], Reason(watcher.clause()));
                     // }
                     // else {
-                    //     trail.propagate(watcher.blocker[1], Reason(watcher.clause));
+                    //     trail.propagate(watcher.blocker[1], Reason(watcher.clause()));
                     // }
-                    trail.propagate(watcher.blocker[val0 & 1], Reason(watcher.clause));
+                    trail.propagate(watcher.blocker[val0 & 1], Reason(watcher.clause()));
                 }
                 else if (val1 == l_False) { // conflict
-                    return Reason(watcher.clause);
+                    if (watcher.clause()->isDeleted()) continue;
+                    return Reason(watcher.clause());
                 }
                 // else if (val1 == l_True) { // swap
                 //     std::swap(watcher.blocker[0], watcher.blocker[1]);
@@ -173,14 +202,14 @@ public:
     }
 
     Reason propagate_watched_clauses(Lit p) {
-        std::vector<WatchX>& list = watchers[p];
+        WatchXList& list = watchers[p];
 
         auto keep = list.begin();
         for (auto watcher = list.begin(); watcher != list.end(); watcher++) {
             lbool val0 = trail.value(watcher->blocker[0]);
 
             if (val0 != l_True) { 
-                Clause* clause = watcher->clause;
+                Clause* clause = watcher->clause();
 
                 if (clause->isDeleted()) continue;
 
@@ -197,7 +226,7 @@ public:
                     for (uint_fast16_t k = 2; k < clause->size(); k++) {
                         if (trail.value((*clause)[k]) != l_False) {
                             clause->swap(1, k);
-                            watchers[~clause->second()].emplace_back(clause, clause->first());
+                            watchers[~clause->second()].emplace_back(watcher->cref, clause->first());
                             goto propagate_skip;
                         }
                     }
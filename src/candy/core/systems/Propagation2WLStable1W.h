@@ -44,7 +44,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/ClauseDatabase.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/Trail.h"
+#include "candy/mtl/Memory.h"
 #include "candy/core/systems/PropagationInterface.h"
 #include <array>
 
@@ -63,8 +65,8 @@ private:
     ClauseDatabase& clause_db;
     Trail& trail;
 
-    std::vector<std::vector<Watcher>> watchers;
-    std::vector<std::vector<Clause*>> alert;
+    std::vector<WatchList> watchers;
+    std::vector<HugePageVector<Clause*>> alert;
 
     unsigned int nDetached = 0;
     unsigned int nReattached = 0;
@@ -106,6 +108,20 @@ public:
         }
     }
 
+    void relocate(const ClauseForwarding& forwarding) override {
+        for (WatchList& list : watchers) {
+            forwarding.relocate(list, [](Watcher& w) -> uint32_t& { return w.cref; });
+        }
+        for (auto& list : alert) {
+            forwarding.relocate(list, [](Clause*& clause) -> Clause*& { return clause; });
+        }
+    }
+
+    void shrink() override {
+        shrink_lists(watchers);
+        shrink_lists(alert);
+    }
+
     void attachClause(Clause* clause) override {
         assert(clause->size() > 2);
         // if (trail.stability[clause->first()] > .9 * trail.nDecisions) {
@@ -126,10 +142,10 @@ public:
             alert[~clause->first()].erase(it);
         }
         else {
-            std::vector<Watcher>& list0 = watchers[~clause->first()];
-            std::vector<Watcher>& list1 = watchers[~clause->second()];
-            list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.cref == clause; }), list0.end());
-            list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.cref == clause; }), list1.end());
+            WatchList& list0 = watchers[~clause->first()];
+            WatchList& list1 = watchers[~clause->second()];
+            list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.clause() == clause; }), list0.end());
+            list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.clause() == clause; }), list1.end());
         }
     }
 
@@ -158,14 +174,14 @@ public:
      *      * the propagation queue is empty, even if there was a conflict.
      **************************************************************************************************/
     Reason propagate_watched_clauses(Lit p) {
-        std::vector<Watcher>& list = watchers[p];
+        WatchList& list = watchers[p];
 
         auto keep = list.begin();
         for (auto watcher = list.begin(); watcher != list.end(); watcher++) {
             lbool val = trail.value(watcher->blocker);
 
             if (val != l_True) { // Try to avoid inspecting the clause
-                Clause* clause = watcher->cref;
+                Clause* clause = watcher->clause();
 
                 if (clause->isDeleted()) continue;
 
@@ -210,6 +226,7 @@ public:
         if (alert[p].size() > 0) {
             Clause* comeback = nullptr;
             for (Clause* clause : alert[p]) {
+                if (clause->isDeleted()) continue;
                 unsigned int w = 0, pos = 0, ppos = 0;
 
                 for (Lit lit : *clause) {
@@ -44,7 +44,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/ClauseDatabase.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/Trail.h"
+#include "candy/mtl/Memory.h"
 #include "candy/core/systems/PropagationInterface.h"
 #include <array>
 #include "candy/mtl/EMA.h"
@@ -64,8 +66,8 @@ private:
     ClauseDatabase& clause_db;
     Trail& trail;
 
-    std::vector<std::vector<Watcher>> watchers;
-    std::vector<std::vector<Clause*>> alert;
+    std::vector<WatchList> watchers;
+    std::vector<HugePageVector<Clause*>> alert;
 
     unsigned int nDetached = 0;
     unsigned int nReattached = 0;
@@ -120,6 +122,20 @@ public:
         return (1 - trail.stability[~clause->first()] / (double)trail.nDecisions) * (1 - trail.stability[~clause->second()] / (double)trail.nDecisions);
     }
 
+    void relocate(const ClauseForwarding& forwarding) override {
+        for (WatchList& list : watchers) {
+            forwarding.relocate(list, [](Watcher& w) -> uint32_t& { return w.cref; });
+        }
+        for (auto& list : alert) {
+            forwarding.relocate(list, [](Clause*& clause) -> Clause*& { return clause; });
+        }
+    }
+
+    void shrink() override {
+        shrink_lists(watchers);
+        shrink_lists(alert);
+    }
+
     void attachClause(Clause* clause) override {
         assert(clause->size() > 2);
         if (clause_stability(clause) > stability_factor) {
@@ -139,10 +155,10 @@ public:
             alert[~clause->first()].erase(it);
         }
         else {
-            std::vector<Watcher>& list0 = watchers[~clause->first()];
-            std::vector<Watcher>& list1 = watchers[~clause->second()];
-            list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.cref == clause; }), list0.end());
-            list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.cref == clause; }), list1.end());
+            WatchList& list0 = watchers[~clause->first()];
+            WatchList& list1 = watchers[~clause->second()];
+            list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.clause() == clause; }), list0.end());
+            list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.clause() == clause; }), list1.end());
         }
     }
 
@@ -171,14 +187,14 @@ public:
      *      * the propagation queue is empty, even if there was a conflict.
      **************************************************************************************************/
     Reason propagate_watched_clauses(Lit p) {
-        std::vector<Watcher>& list = watchers[p];
+        WatchList& list = watchers[p];
 
         auto keep = list.begin();
         for (auto watcher = list.begin(); watcher != list.end(); watcher++) {
             lbool val = trail.value(watcher->blocker);
 
             if (val != l_True) { // Try to avoid inspecting the clause
-                Clause* clause = watcher->cref;
+                Clause* clause = watcher->clause();
 
                 if (clause->isDeleted()) continue;
 
@@ -223,6 +239,7 @@ public:
         if (alert[p].size() > 0) {
             Clause* rollback = nullptr;
             for (Clause* clause : alert[p]) {
+                if (clause->isDeleted()) continue;
                 assert(clause->first() == ~p);
                 unsigned found = 0;
 
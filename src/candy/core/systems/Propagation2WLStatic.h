@@ -23,6 +23,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/ClauseDatabase.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/Trail.h"
 #include "candy/mtl/Memory.h"
 #include "candy/core/systems/PropagationInterface.h"
@@ -32,19 +33,23 @@ namespace Candy {
 
 class Propagation2WLStatic : public PropagationInterface {
     struct Watcher {
-        Clause* cref;
+        uint32_t cref; // arena-relative clause reference
         Lit watch0;
         Lit watch1;
 
         Watcher(Clause* clause, Lit one, Lit two)
-         : cref(clause), watch0(one), watch1(two) {}
+         : cref(ClauseArena::ref(clause)), watch0(one), watch1(two) {}
+
+        inline Clause* clause() const {
+            return ClauseArena::clause(cref);
+        }
     };
 
 private:
     ClauseDatabase& clause_db;
     Trail& trail;
 
-    std::vector<std::vector<Watcher*>> watchers;
+    std::vector<HugePageVector<Watcher*>> watchers;
 
     Memory<Watcher> memory;
 
@@ -62,6 +67,7 @@ public:
 
     void reset() override {
         for (auto& w : watchers) w.clear();
+        memory.free_all();
         for (Clause* clause : clause_db) {
             if (clause->size() > 2) {
                 attachClause(clause);
@@ -69,6 +75,16 @@ public:
         }
     }
 
+    void relocate(const ClauseForwarding& forwarding) override {
+        for (auto& list : watchers) {
+            forwarding.relocate(list, [](Watcher* w) -> uint32_t& { return w->cref; });
+        }
+    }
+
+    void shrink() override {
+        shrink_lists(watchers);
+    }
+
     void attachClause(Clause* clause) override {
         assert(clause->size() > 2);
         Watcher* watcher = new (memory.allocate()) Watcher(clause, clause->first(), clause->second());
@@ -79,7 +95,7 @@ public:
     void detachClause(Clause* clause) override {
         assert(clause->size() > 2);
         for (Lit lit : *clause) {
-            auto it = std::find_if(watchers[~lit].begin(), watchers[~lit].end(), [clause](Watcher* w){ return w->cref == clause; });
+            auto it = std::find_if(watchers[~lit].begin(), watchers[~lit].end(), [clause](Watcher* w){ return w->clause() == clause; });
             if (it != watchers[~lit].end()) {
                 Watcher* watcher = *it;
                 Lit lit0 = watcher->watch0;
@@ -116,7 +132,7 @@ public:
      *      * the propagation queue is empty, even if there was a conflict.
      **************************************************************************************************/
     inline Reason propagate_watched_clauses(Lit p) {
-        std::vector<Watcher*>& list = watchers[p];
+        HugePageVector<Watcher*>& list = watchers[p];
 
         auto keep = list.begin();
         for (auto iter = list.begin(); iter != list.end(); iter++) {
@@ -125,7 +141,10 @@ public:
             Lit other = watcher->watch0 != ~p ? watcher->watch0 : watcher->watch1;
             lbool val = trail.value(other);
             if (val != l_True) { // Try to avoid inspecting the clause
-                Clause* clause = watcher->cref;                
+                Clause* clause = watcher->clause();
+
+                if (clause->isDeleted()) continue;
+
                 for (Lit lit : *clause) {
                     if (lit != ~p && lit != other && trail.value(lit) != l_False) {
                         watcher->watch0 = lit;
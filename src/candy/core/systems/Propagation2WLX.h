@@ -44,8 +44,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/ClauseDatabase.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/clauses/NaryClauses.h"
 #include "candy/core/Trail.h"
+#include "candy/mtl/Memory.h"
 #include "candy/core/systems/PropagationInterface.h"
 
 namespace Candy {
@@ -81,11 +83,14 @@ public:
                     }
                 }
             }
+            if (o.clause()->isDeleted()) { // not yet dropped by relocate() or reset()
+                goto continue2;
+            }
             if (prop == lit_Undef) {
-                return Reason(o.clause);
+                return Reason(o.clause());
             } 
             else {
-                trail.propagate(prop, Reason(o.clause));
+                trail.propagate(prop, Reason(o.clause()));
             }
             continue2:;
         }
@@ -96,6 +101,16 @@ public:
         nary.clear();
     }
 
+    inline void relocate(const ClauseForwarding& forwarding) {
+        for (auto& list : nary.lists) {
+            forwarding.relocate(list, [](Occurrence<X>& o) -> uint32_t& { return o.cref; });
+        }
+    }
+
+    inline void shrink() {
+        shrink_lists(nary.lists);
+    }
+
     inline void attach(Clause* clause) {
         nary.add(clause);
     }
@@ -110,6 +125,8 @@ public:
     PropagateX(unsigned int nVars) {}
     inline Reason propagate_nary_clauses(Trail& trail, Lit p) { return Reason(); }
     inline void clear() {}
+    inline void relocate(const ClauseForwarding& forwarding) {}
+    inline void shrink() {}
     inline void attach(Clause* clause) {}
     inline void detach(Clause* clause) {}
 };
@@ -129,7 +146,7 @@ class Propagation2WLX : public PropagationInterface, public PropagateX<X>, publi
     ClauseDatabase& clause_db;
     Trail& trail;
 
-    std::vector<std::vector<Watcher>> watchers;
+    std::vector<WatchList> watchers;
 
 public:
     Propagation2WLX(ClauseDatabase& _clause_db, Trail& _trail) : 
@@ -156,6 +173,22 @@ public:
         }
     }
 
+    void relocate(const ClauseForwarding& forwarding) override {
+        for (WatchList& list : watchers) {
+            forwarding.relocate(list, [](Watcher& w) -> uint32_t& { return w.cref; });
+        }
+        PropagateX<X>::relocate(forwarding);
+        PropagateX<Y>::relocate(forwarding);
+        PropagateX<Z>::relocate(forwarding);
+    }
+
+    void shrink() override {
+        shrink_lists(watchers);
+        PropagateX<X>::shrink();
+        PropagateX<Y>::shrink();
+        PropagateX<Z>::shrink();
+    }
+
     void attachClause(Clause* clause) override {
         assert(clause->size() > 2);
 
@@ -187,10 +220,10 @@ public:
             PropagateX<Z>::detach(clause);
         }
         else {
-            std::vector<Watcher>& list0 = watchers[~clause->first()];
-            std::vector<Watcher>& list1 = watchers[~clause->second()];
-            list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.cref == clause; }), list0.end());
-            list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.cref == clause; }), list1.end());
+            WatchList& list0 = watchers[~clause->first()];
+            WatchList& list1 = watchers[~clause->second()];
+            list0.erase(std::remove_if(list0.begin(), list0.end(), [clause](Watcher w){ return w.clause() == clause; }), list0.end());
+            list1.erase(std::remove_if(list1.begin(), list1.end(), [clause](Watcher w){ return w.clause() == clause; }), list1.end());
         }
     }
 
@@ -208,14 +241,14 @@ public:
     }
 
     Reason propagate_watched_clauses(Lit p) {
-        std::vector<Watcher>& list = watchers[p];
+        WatchList& list = watchers[p];
 
         auto keep = list.begin();
         for (auto watcher = list.begin(); watcher != list.end(); watcher++) {
             lbool val = trail.value(watcher->blocker);
 
             if (val != l_True) { // Try to avoid inspecting the clause
-                Clause* clause = watcher->cref;
+                Clause* clause = watcher->clause();
 
                 if (clause->isDeleted()) continue;
 
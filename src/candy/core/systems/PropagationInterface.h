@@ -20,18 +20,23 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef PROPAGATION_INTERFACE_H_
 #define PROPAGATION_INTERFACE_H_
 
+#include <cstddef>
+
 #include "candy/core/SolverTypes.h"
 
 namespace Candy {
 
 class Clause;
+class ClauseForwarding;
 
 class PropagationInterface {
 public:
     virtual void reset() = 0;
+    virtual void relocate(const ClauseForwarding& forwarding) = 0;
     virtual void attachClause(Clause* clause) = 0;
     virtual void detachClause(Clause* clause) = 0;
     virtual Reason propagate() = 0;
+    virtual void shrink() = 0; // release unused capacity of the lists
 };
 
 }
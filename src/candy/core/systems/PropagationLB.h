@@ -23,7 +23,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "candy/core/SolverTypes.h"
 #include "candy/core/clauses/ClauseDatabase.h"
 #include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseForwarding.h"
 #include "candy/core/Trail.h"
+#include "candy/mtl/Memory.h"
 #include "candy/core/systems/PropagationInterface.h"
 #include <array>
 
@@ -45,7 +47,7 @@ private:
     ClauseDatabase& clause_db;
     Trail& trail;
 
-    std::vector<std::vector<LowerBound*>> bounds;
+    std::vector<HugePageVector<LowerBound*>> bounds;
 
     Memory<LowerBound> memory;
 
@@ -65,6 +67,7 @@ public:
 
     void reset() override {
         for (auto& b : bounds) b.clear();
+        memory.free_all();
         for (Clause* clause : clause_db) {
             if (clause->size() > 2) {
                 attachClause(clause);
@@ -72,6 +75,16 @@ public:
         }
     }
 
+    void relocate(const ClauseForwarding& forwarding) override {
+        for (auto& list : bounds) {
+            forwarding.relocate(list, [](LowerBound* lb) -> Clause*& { return lb->clause; });
+        }
+    }
+
+    void shrink() override {
+        shrink_lists(bounds);
+    }
+
     void attachClause(Clause* clause) override {
         assert(clause->size() > 2);
         LowerBound* lb = new (memory.allocate()) LowerBound(clause);
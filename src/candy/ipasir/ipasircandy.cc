@@ -91,8 +91,9 @@ public:
             solver = createSolver(problem);
         }
         else if (problem.nVars() <= solver->nVars()) {
-            for (Cl* clause : problem) {
-                solver->addClause(clause);
+            for (CNFClause clause : problem) {
+                Cl lits(clause.begin(), clause.end());
+                solver->addClause(&lits);
             }
         }
         else {
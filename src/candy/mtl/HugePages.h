@@ -0,0 +1,183 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2020, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_CANDY_MTL_HUGEPAGES_H_
+#define SRC_CANDY_MTL_HUGEPAGES_H_
+
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#if defined(__unix__) || defined(__unix) || defined(unix) || (defined(__APPLE__) && defined(__MACH__))
+#include <sys/mman.h>
+#define CANDY_HAVE_MMAP
+#endif
+
+#include "candy/utils/CLIOptions.h"
+
+namespace Candy {
+
+/**
+ * class HugePages:
+ * 
+ *  Large regions are mapped 2 MB aligned and advised for transparent huge pages (mode 1), 
+ *  or mapped from the explicit huge page pool (hugetlbfs, mode 2) with a fallback to transparent 
+ *  huge pages if the pool is exhausted. Small regions, and all regions on systems without mmap, come from the heap.
+ *  The bytes allocated by all solvers of the process are counted (see allocated()), object pools map their 
+ *  pages uncounted and count only the bytes of their objects.
+ * 
+ * */
+class HugePages {
+public:
+    static const size_t page_size = 2 * 1024 * 1024;
+
+    static inline size_t round(size_t bytes) {
+        return (bytes + page_size - 1) / page_size * page_size;
+    }
+
+    /* advise transparent huge pages for an aligned range of mapped memory */
+    static inline void advise(void* memory, size_t bytes) {
+#if defined(CANDY_HAVE_MMAP) && defined(MADV_HUGEPAGE)
+        if (SolverOptions::opt_huge_pages > 0) {
+            madvise(memory, bytes, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    /* replace an aligned range of mapped memory by explicit huge pages (the range might be unmapped on failure) */
+    static inline bool remap(void* memory, size_t bytes) {
+#if defined(CANDY_HAVE_MMAP) && defined(MAP_HUGETLB)
+        return mmap(memory, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0) != MAP_FAILED;
+#else
+        return false;
+#endif
+    }
+
+    /* bytes currently allocated through HugePages by all solvers of the process */
+    static inline size_t allocated() {
+        return counter().load(std::memory_order_relaxed);
+    }
+
+    static inline void occupy(size_t bytes) {
+        counter().fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    static inline void vacate(size_t bytes) {
+        counter().fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    static void* allocate(size_t bytes) {
+        void* memory = map(bytes);
+        occupy(bytes);
+        return memory;
+    }
+
+    static void release(void* memory, size_t bytes) {
+        vacate(bytes);
+        unmap(memory, bytes);
+    }
+
+    /* uncounted memory, e.g. for pages of an object pool */
+    static void* map(size_t bytes) {
+#ifdef CANDY_HAVE_MMAP
+        if (bytes < page_size) {
+#endif
+            void* memory = std::malloc(bytes);
+            if (memory == nullptr) throw std::bad_alloc();
+            return memory;
+#ifdef CANDY_HAVE_MMAP
+        }
+        bytes = round(bytes);
+#ifdef MAP_HUGETLB
+        if (SolverOptions::opt_huge_pages == 2) {
+            void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (memory != MAP_FAILED) return memory;
+        }
+#endif
+        // over-allocate and trim to 2 MB alignment
+        char* mapping = (char*)mmap(nullptr, bytes + page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) throw std::bad_alloc();
+        char* memory = (char*)(((uintptr_t)mapping + page_size - 1) & ~(uintptr_t)(page_size - 1));
+        size_t head = memory - mapping;
+        if (head > 0) munmap(mapping, head);
+        munmap(memory + bytes, page_size - head);
+        advise(memory, bytes);
+        return memory;
+#endif
+    }
+
+    static void unmap(void* memory, size_t bytes) {
+#ifdef CANDY_HAVE_MMAP
+        if (bytes >= page_size) {
+            munmap(memory, round(bytes));
+            return;
+        }
+#endif
+        std::free(memory);
+    }
+
+private:
+    static inline std::atomic<size_t>& counter() {
+        static std::atomic<size_t> bytes { 0 };
+        return bytes;
+    }
+
+};
+
+/**
+ * Allocator for standard containers, e.g. watch lists, which backs large buffers with huge pages
+ * and counts their bytes in HugePages::allocated()
+ * */
+template<class T>
+class HugePageAllocator {
+public:
+    typedef T value_type;
+
+    HugePageAllocator() noexcept { }
+
+    template<class U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept { }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(HugePages::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        HugePages::release(p, n * sizeof(T));
+    }
+
+    template<class U>
+    bool operator == (const HugePageAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template<class U>
+    bool operator != (const HugePageAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+template<class T>
+using HugePageVector = std::vector<T, HugePageAllocator<T>>;
+
+}
+
+#endif
@@ -27,6 +27,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <vector>
 #include <algorithm>
 
+#include "candy/mtl/HugePages.h"
+
 namespace Candy {
 
 template<class T> 
@@ -72,8 +74,7 @@ private:
 
 public:
     MemoryPage(size_t page_size_) : page_size(page_size_), cursor(0) {
-        memory = (unsigned char*)std::malloc(page_size);
-        // std::memset(memory, page_size, 0);
+        memory = (unsigned char*)HugePages::map(page_size); // only the objects are counted
     }
 
     MemoryPage(MemoryPage&& other) : page_size(other.page_size), cursor(other.cursor), memory(other.memory) {
@@ -84,7 +85,8 @@ public:
 
     ~MemoryPage() {
         if (memory != nullptr) {
-            std::free((void*)memory);
+            HugePages::vacate(cursor);
+            HugePages::unmap((void*)memory, page_size);
             memory = nullptr;
         }
     }
@@ -98,6 +100,7 @@ public:
         assert(memory != nullptr);
         void* result = memory + cursor;
         cursor += sizeof(T);
+        HugePages::occupy(sizeof(T));
         return result;
     }
 
@@ -118,6 +121,7 @@ public:
     }
 
     inline void reset() {
+        HugePages::vacate(cursor);
         cursor = 0;
     }
 
@@ -246,9 +250,9 @@ public:
         pages.clear();
     }
 
-    inline size_t used() {
+    inline size_t used() const {
         size_t size = 0;
-        for (MemoryPage<T>& page : pages) {
+        for (const MemoryPage<T>& page : pages) {
             size += page.used();
         }
         return size;
@@ -273,6 +277,16 @@ public:
 
 };
 
+/**
+ * Release the unused capacity of a vector of lists (e.g. watch lists)
+ * */
+template<class Lists>
+inline void shrink_lists(Lists& lists) {
+    for (auto& list : lists) {
+        list.shrink_to_fit();
+    }
+}
+
 }
 
 #endif
\ No newline at end of file
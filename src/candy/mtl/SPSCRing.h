@@ -0,0 +1,80 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2020, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SPSC_Ring
+#define SPSC_Ring
+
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+/**
+ * Lock-free ring of bytes for one producer and one consumer thread. 
+ * The counters of written and read bytes only grow, their difference is the fill level.
+ * */
+class SPSCRing {
+    std::unique_ptr<char[]> data;
+    size_t capacity; // power of two
+    std::atomic<size_t> head; // bytes written by the producer
+    char padding[64]; // keep the counters on different cache lines
+    std::atomic<size_t> tail; // bytes read by the consumer
+
+public:
+    explicit SPSCRing(size_t capacity_) : data(), capacity(1), head(0), tail(0) {
+        while (capacity < capacity_) capacity <<= 1;
+        data.reset(new char[capacity]);
+    }
+
+    /** Producer: copy as much of [src, src+size) as fits, returns the number of bytes copied */
+    size_t push(const char* src, size_t size) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t count = std::min(size, capacity - (h - tail.load(std::memory_order_acquire)));
+        size_t offset = h & (capacity - 1);
+        size_t first = std::min(count, capacity - offset);
+        memcpy(data.get() + offset, src, first);
+        memcpy(data.get(), src + first, count - first);
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    /** Consumer: begin and size of the contiguous readable part */
+    size_t peek(const char*& begin) const {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t size = head.load(std::memory_order_acquire) - t;
+        size_t offset = t & (capacity - 1);
+        begin = data.get() + offset;
+        return std::min(size, capacity - offset);
+    }
+
+    /** Consumer: release bytes returned by peek */
+    void pop(size_t size) {
+        tail.store(tail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+    }
+
+    size_t written() const {
+        return head.load(std::memory_order_acquire);
+    }
+
+    size_t read() const {
+        return tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif
@@ -21,6 +21,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define SRC_CANDY_CORE_SUBSUMPTION_CLAUSE_DATABASE_H_
 
 #include <vector>
+#include <unordered_map>
 
 #include "candy/core/clauses/Clause.h"
 #include "candy/core/clauses/ClauseDatabase.h"
@@ -30,9 +31,10 @@ namespace Candy {
 class OccurenceList {
 private:
     std::vector<std::vector<Clause*>> occurrences;
+    std::unordered_map<const Clause*, uint32_t> abstractions; // not stored in the clause header
 
 public:
-    OccurenceList(ClauseDatabase& clause_db) : occurrences() {
+    OccurenceList(ClauseDatabase& clause_db) : occurrences(), abstractions() {
         occurrences.resize(clause_db.nVars());
         for (Clause* clause : clause_db) {
             if (!clause->isDeleted()) add(clause);
@@ -45,6 +47,12 @@ public:
         for (Lit lit : *clause) {
             occurrences[lit.var()].push_back(clause);
         }
+        abstractions[clause] = clause->abstraction();
+    }
+
+    inline uint32_t abstraction(const Clause* clause) const {
+        auto it = abstractions.find(clause);
+        return it != abstractions.end() ? it->second : clause->abstraction();
     }
 
     inline void cleanup() {
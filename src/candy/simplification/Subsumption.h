@@ -100,9 +100,11 @@ void Subsumption::subsume(OccurenceList& occurences, Clause* clause) {
     Lit best = *std::min_element(clause->begin(), clause->end(), [&occurences] (Lit l1, Lit l2) {
         return occurences.count(l1.var()) < occurences.count(l2.var());
     });
+    uint32_t abstraction = occurences.abstraction(clause);
     for (unsigned int i = 0; i < occurences[best.var()].size() && !clause_db.hasEmptyClause(); i++) {
         Clause* occurence = occurences[best.var()][i];
-        if (occurence != clause && !occurence->isDeleted() && !clause->isDeleted()) {
+        if (occurence != clause && !occurence->isDeleted() && !clause->isDeleted() 
+            && (abstraction & ~occurences.abstraction(occurence)) == 0) {
             Lit l = clause->subsumes(occurence);
 
             if (l == lit_Undef) { 
@@ -118,13 +120,13 @@ void Subsumption::subsume(OccurenceList& occurences, Clause* clause) {
             else if (l != lit_Error) {
                 nStrengthened++;   
                 if (occurence->size() > 1) {
-                    Clause* strengthened = clause_db.strengthenClause(occurence, ~l);
+                    Clause* strengthened = clause_db.strengthenClause(occurence, ~l, { clause->id(), occurence->id() });
                     occurences.add(strengthened);
                     if (verbosity > 1) std::cout << *clause << " strengthens " << *occurence << std::endl;
                     subsume(occurences, strengthened);
                 } 
                 else {
-                    clause_db.emptyClause();
+                    clause_db.emptyClause({ clause->id(), occurence->id() });
                 }
             }
         }
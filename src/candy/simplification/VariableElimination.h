@@ -59,10 +59,12 @@ private:
 
     const bool active;          // Perform variable elimination.
     const unsigned int clause_lim;     // Variables are not eliminated if it produces a resolvent with a length above this limit. 0 means no limit.
+    const bool lrat;            // Eliminated clauses stay in the proof, restored clauses are derived from them.
 
 public:
     std::vector<Var> variables;
     std::vector<std::vector<Cl>> clauses;
+    std::vector<std::vector<uint32_t>> ids; // LRAT ids of the eliminated clauses
 
     unsigned int nEliminated;
 
@@ -73,10 +75,12 @@ public:
         resolvent(),
         active(VariableEliminationOptions::opt_use_elim),
         clause_lim(VariableEliminationOptions::opt_clause_lim), 
-        variables(), clauses(), 
+        lrat(clause_db_.antecedents.active()),
+        variables(), clauses(), ids(), 
         nEliminated(0), verbosity(Verbosity::elimination_verbosity)
     { 
         clauses.resize(clause_db.nVars());
+        if (lrat) ids.resize(clause_db.nVars());
     }
 
     void undo_assumptions() {
@@ -91,10 +95,16 @@ public:
         assert(is_eliminated(var));
         auto begin = std::find(variables.begin(), variables.end(), var);
         for (auto vit = begin; vit != variables.end(); vit++) {
-            for (Cl& cl : clauses[*vit]) {
-                clause_db.createClause(cl.begin(), cl.end());
+            for (size_t i = 0; i < clauses[*vit].size(); i++) {
+                Cl& cl = clauses[*vit][i];
+                if (lrat) {
+                    clause_db.createClause(cl.begin(), cl.end(), 0, false, { ids[*vit][i] }); // by the original clause, which stays in the proof
+                } else {
+                    clause_db.createClause(cl.begin(), cl.end());
+                }
             }
             clauses[*vit].clear();
+            if (lrat) ids[*vit].clear();
             trail.setDecisionVar(*vit, true);
         }
         variables.erase(begin, variables.end());
@@ -176,6 +186,10 @@ public:
         variables.push_back(var);
         for (Clause* c : pos) clauses[var].push_back(Cl {c->begin(), c->end()} );
         for (Clause* c : neg) clauses[var].push_back(Cl {c->begin(), c->end()} );
+        if (lrat) {
+            for (Clause* c : pos) ids[var].push_back(c->id());
+            for (Clause* c : neg) ids[var].push_back(c->id());
+        }
         trail.setDecisionVar(var, false);
         nEliminated++;
     }
@@ -191,7 +205,7 @@ private:
             unsigned int clause_size = 0;
             if (merge(*pc, *nc, variable, clause_size)) {
                 if (clause_size == 0) {
-                    clause_db.emptyClause();
+                    clause_db.emptyClause({ pc->id(), nc->id() });
                     return;
                 }
                 if (++nResolvents > pos.size() + neg.size() || (clause_lim > 0 && clause_size > clause_lim)) {
@@ -204,9 +218,9 @@ private:
             if (merge(*pc, *nc, variable, resolvent)) {
                 uint16_t lbd = std::min({ (uint16_t)pc->getLBD(), (uint16_t)nc->getLBD(), (uint16_t)(resolvent.size()-1) });
                 if (verbosity > 1) std::cout << "c Creating resolvent " << resolvent << std::endl;
-                Clause* clause = clause_db.createClause(resolvent.begin(), resolvent.end(), lbd);
+                Clause* clause = clause_db.createClause(resolvent.begin(), resolvent.end(), lbd, false, { pc->id(), nc->id() });
                 occurences.add(clause);
-                if (trail.falsifies(clause->begin(), clause->end())) clause_db.emptyClause();
+                if (trail.falsifies(clause->begin(), clause->end())) clause_db.refute(trail, Reason(clause));
             }
         }
 
@@ -214,10 +228,10 @@ private:
         set_eliminated(variable, pos, neg);
 
         for (Clause* clause : pos) {
-            clause_db.removeClause(clause);
+            clause_db.removeClause(clause, !lrat);
         }
         for (Clause* clause : neg) {
-            clause_db.removeClause(clause);
+            clause_db.removeClause(clause, !lrat);
         }
     }
 
@@ -32,6 +32,7 @@ namespace ParallelOptions {
     BoolOption opt_lb_propagate("ParallelOptions", "lb-propagate", "use static lower-bounds propagation module", false);
     BoolOption opt_static_database("ParallelOptions", "static-database", "Use thread-safe static clause-allocator", false);
     IntOption opt_static_database_size_bound("ParallelOptions", "static_database_size_bound", "upper size-bound for static database (0 = disabled, 1+2 = no effect, 3++ = size-bound", 6, IntRange(0, INT16_MAX));
+    IntOption opt_parse_threads("ParallelOptions", "parse-threads", "Number of threads for parsing the input (0 = number of cores)", 0, IntRange(0, 256));
 }
 
 namespace Stability {
@@ -54,11 +55,17 @@ namespace ClauseDatabaseOptions {
 
     IntOption opt_first_reduce_db("ClauseDatabase", "firstReduceDB", "The number of conflicts before the first reduce DB", 3000, IntRange(0, INT16_MAX));
     IntOption opt_inc_reduce_db("ClauseDatabase", "incReduceDB", "Increment for reduce DB", 1300, IntRange(0, INT16_MAX));
+
+    IntOption opt_reorganize_threshold("ClauseDatabase", "reorganize-threshold", "Percentage of clause memory occupied by deleted clauses which were not reused that triggers a full defragmentation, below it their memory is reused (0 = defragment on every reduce)", 20, IntRange(0, 100));
+    BoolOption opt_reorganize_by_watches("ClauseDatabase", "reorganize-by-watches", "Relocate clauses in the order of the watch lists visited by the last assignment", false);
+    IntOption opt_defrag_pages("ClauseDatabase", "defrag-pages", "Evacuate at most this many fragmented pages per restart instead of reorganizing all clauses on reduce (0 = off)", 0, IntRange(0, INT32_MAX));
 }
 
 namespace TestingOptions {
     BoolOption test_model("TEST", "test-model", "test model.", false);
     BoolOption test_proof("TEST", "test-proof", "test proof.", false);
+    BoolOption test_proof_backward("TEST", "test-proof-backward", "check proofs backwards, verifying only the lemmas needed for the refutation", true);
+    IntOption test_proof_threads("TEST", "test-proof-threads", "check all lemmas of proofs forward in parallel slices with the given number of threads ('1' means sequential)", 1, IntRange(1, 256));
     IntOption test_limit("TEST", "test-limit", "limit the number of variables ('0' means inactive).", 0, IntRange(0, 1000));
 }
 
@@ -69,10 +76,19 @@ namespace LearningOptions {
 namespace SolverOptions {
     IntOption verb("MAIN", "verb", "Verbosity level (0=silent, 1=some, 2=more).", 1, IntRange(0, 2));
     BoolOption mod("MAIN", "model", "show model.", false);
+    StringOption opt_model_file("MAIN", "model-file", "Write status and model to this file instead of the standard output.", "");
     StringOption opt_certified_file("MAIN", "certified-output", "Certified UNSAT output file", "");
+    BoolOption opt_certified_binary("MAIN", "certified-binary", "Write the certified UNSAT output in binary DRAT format", false);
+    BoolOption opt_certified_async("MAIN", "certified-async", "Write the certified UNSAT output on a background thread", false);
+    BoolOption opt_certified_lrat("MAIN", "certified-lrat", "Write the certified UNSAT output in LRAT format with antecedents of lemmas", false);
+    BoolOption opt_cnf_cache("MAIN", "cnf-cache", "Write binary cache <input>.bcnf (an up-to-date cache is always used).", false);
+    StringOption opt_result_cache("MAIN", "result-cache", "Directory of a result cache indexed by instance fingerprint (empty = no cache), unsatisfiable instances are solved again if a proof is requested", "");
+    BoolOption opt_stream_input("MAIN", "stream-input", "Parse the clauses directly into the clause database of the solver (the formula is not stored separately).", false);
+    BoolOption opt_release_problem("MAIN", "release-problem", "Free the input formula once the solver is initialized (the model is checked by re-reading the file).", false);
     BoolOption gate_stats("MAIN", "gate-stats", "show only gate recognizer statistics.", false);
 
-    IntOption memory_limit("MAIN", "memory-limit", "Limit on memory usage in mega bytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+    IntOption opt_huge_pages("MAIN", "huge-pages", "Back clause pages, object pools and large watch lists with huge pages (0 = off, 1 = transparent, 2 = explicit with fallback to transparent)", 0, IntRange(0, 2));
+    IntOption memory_limit("MAIN", "memory-limit", "Limit in mega bytes on the clauses, watch and occurrence lists and clause metadata of all solvers in the process (0 = no limit). Other memory, e.g. the input formula, is not counted and the resident memory is not checked. The clause database is reduced early and compacted when 3/4 of the limit are reached, solving stops (INDETERMINATE) if that cannot keep to the limit.\n", 0, IntRange(0, INT32_MAX));
     IntOption time_limit("MAIN", "time-limit", "Limit on wallclock runtime in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
     
     DoubleOption opt_restart_force("Restarts", "restart-force", "The constant used to force restart", 1.3, DoubleRange(1, false, 5, false));
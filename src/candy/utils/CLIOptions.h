@@ -33,6 +33,7 @@ namespace ParallelOptions {
     extern IntOption opt_Xfull_propagate; // X-Z clauses full
     extern BoolOption opt_static_database;
     extern IntOption opt_static_database_size_bound;
+    extern IntOption opt_parse_threads;
 }
 
 namespace Stability {
@@ -55,11 +56,17 @@ namespace ClauseDatabaseOptions {
     
     extern IntOption opt_first_reduce_db;
     extern IntOption opt_inc_reduce_db;
+
+    extern IntOption opt_reorganize_threshold;
+    extern BoolOption opt_reorganize_by_watches;
+    extern IntOption opt_defrag_pages;
 }
 
 namespace TestingOptions {
     extern BoolOption test_model;
     extern BoolOption test_proof;
+    extern BoolOption test_proof_backward;
+    extern IntOption test_proof_threads;
     extern IntOption test_limit;
 }
 
@@ -70,9 +77,18 @@ namespace LearningOptions {
 namespace SolverOptions {
     extern IntOption verb;
     extern BoolOption mod;
+    extern StringOption opt_model_file;
     extern StringOption opt_certified_file;
+    extern BoolOption opt_certified_binary;
+    extern BoolOption opt_certified_async;
+    extern BoolOption opt_certified_lrat;
+    extern BoolOption opt_cnf_cache;
+    extern StringOption opt_result_cache;
+    extern BoolOption opt_stream_input;
+    extern BoolOption opt_release_problem;
     extern BoolOption gate_stats;
 
+    extern IntOption opt_huge_pages;
     extern IntOption memory_limit;
     extern IntOption time_limit;
 
@@ -0,0 +1,115 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2019, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include "candy/utils/ResultCache.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace Candy {
+
+std::string ResultCache::filename(uint64_t fingerprint) const {
+    std::stringstream name;
+    name << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << fingerprint << ".result";
+    return name.str();
+}
+
+lbool ResultCache::lookup(uint64_t fingerprint, std::vector<Lit>& model, std::string& proof) const {
+    model.clear();
+    proof.clear();
+    std::ifstream in(filename(fingerprint));
+    lbool status = l_Undef;
+    bool complete = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream tokens(line);
+        std::string type;
+        tokens >> type;
+        if (type == "s") {
+            std::string value;
+            tokens >> value;
+            status = value == "SATISFIABLE" ? l_True : value == "UNSATISFIABLE" ? l_False : l_Undef;
+            complete = status == l_False;
+        }
+        else if (type == "v") {
+            for (int plit; tokens >> plit; ) {
+                if (plit == 0) {
+                    complete = true;
+                    break;
+                }
+                model.push_back(Lit(abs(plit)-1, plit < 0));
+            }
+        }
+        else if (type == "c") {
+            std::string key;
+            if (tokens >> key && key == "proof") {
+                tokens >> std::ws;
+                std::getline(tokens, proof);
+            }
+        }
+    }
+    if (!complete) {
+        model.clear();
+        proof.clear();
+        return l_Undef;
+    }
+    return status;
+}
+
+bool ResultCache::store(uint64_t fingerprint, lbool status, const std::vector<Lit>& model, const std::string& proof) const {
+    if (status == l_Undef) {
+        return false;
+    }
+    std::string target = filename(fingerprint);
+    std::string temporary = target + "." + std::to_string(getpid());
+    std::ofstream out(temporary);
+    if (!out.is_open()) {
+        return false;
+    }
+    if (status == l_True) {
+        out << "s SATISFIABLE" << "\n" << "v";
+        for (Lit lit : model) {
+            out << " " << (lit.sign() ? -(lit.var()+1) : lit.var()+1);
+        }
+        out << " 0" << "\n";
+    }
+    else {
+        out << "s UNSATISFIABLE" << "\n";
+        if (!proof.empty()) {
+            out << "c proof " << proof << "\n";
+        }
+    }
+    out.close();
+    if (out.fail() || std::rename(temporary.c_str(), target.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+}
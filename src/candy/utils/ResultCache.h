@@ -0,0 +1,53 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2019, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_CANDY_UTILS_RESULTCACHE_H_
+#define SRC_CANDY_UTILS_RESULTCACHE_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "candy/core/SolverTypes.h"
+
+namespace Candy {
+
+/**
+ * On-disk cache of solver results indexed by instance fingerprint (cf. CNFProblem::fingerprint). 
+ * Each result is a small DIMACS-style file <directory>/<fingerprint>.result with the status line, 
+ * the model of satisfiable instances and optionally the location of a proof.
+ * */
+class ResultCache {
+    std::string directory;
+
+public:
+    ResultCache(const char* directory_) : directory(directory_) { }
+
+    std::string filename(uint64_t fingerprint) const;
+
+    /** Returns l_Undef if there is no cached result */
+    lbool lookup(uint64_t fingerprint, std::vector<Lit>& model, std::string& proof) const;
+
+    /** Files are written to a temporary name first, such that concurrent readers never see partial results */
+    bool store(uint64_t fingerprint, lbool status, const std::vector<Lit>& model, const std::string& proof) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2019, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include "candy/utils/ResultWriter.h"
+#include "candy/core/CandySolverResult.h"
+
+#include <cstring>
+
+namespace Candy {
+
+ResultWriter::ResultWriter(FILE* out_) : out(out_), owned(false), buffer(buffer_size), used(0) { }
+
+ResultWriter::ResultWriter(const char* filename) : out(fopen(filename, "w")), owned(true), buffer(buffer_size), used(0) { }
+
+ResultWriter::~ResultWriter() {
+    flush();
+    if (owned && out != nullptr) {
+        fclose(out);
+    }
+}
+
+bool ResultWriter::flush() {
+    bool success = out != nullptr && fwrite(buffer.data(), 1, used, out) == used && fflush(out) == 0;
+    used = 0;
+    return success;
+}
+
+void ResultWriter::write(const char* str) {
+    size_t length = strlen(str);
+    ensure(length);
+    memcpy(buffer.data() + used, str, length);
+    used += length;
+}
+
+void ResultWriter::writeInteger(int value) {
+    char digits[12];
+    char* end = digits + sizeof(digits);
+    char* begin = end;
+    unsigned int magnitude = value < 0 ? -static_cast<unsigned int>(value) : value;
+    do {
+        *--begin = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) *--begin = '-';
+    memcpy(buffer.data() + used, begin, end - begin);
+    used += end - begin;
+}
+
+void ResultWriter::writeStatus(lbool status) {
+    write(status == l_True ? "s SATISFIABLE\n" : status == l_False ? "s UNSATISFIABLE\n" : "s INDETERMINATE\n");
+}
+
+void ResultWriter::writeModel(const CandySolverResult& result, unsigned int nVars) {
+    size_t column = 1;
+    write("v");
+    for (Var v = 0; v < (Var)nVars; v++) {
+        lbool value = result.modelValue(v);
+        if (value == l_Undef) continue;
+        ensure(14); // line break, separator and 11 characters of the literal
+        if (column + 12 > line_length) {
+            buffer[used++] = '\n';
+            buffer[used++] = 'v';
+            column = 1;
+        }
+        size_t begin = used;
+        buffer[used++] = ' ';
+        writeInteger(value == l_False ? -(v+1) : v+1);
+        column += used - begin;
+    }
+    write(" 0\n");
+}
+
+}
@@ -0,0 +1,76 @@
+/*************************************************************************************************
+Candy -- Copyright (c) 2015-2019, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_CANDY_UTILS_RESULTWRITER_H_
+#define SRC_CANDY_UTILS_RESULTWRITER_H_
+
+#include <cstdio>
+#include <vector>
+
+#include "candy/core/SolverTypes.h"
+
+namespace Candy {
+
+class CandySolverResult;
+
+/**
+ * Writes status and model in the competition format. Integers are formatted into a large buffer 
+ * which is written with few system calls, and models are split into 'v' lines of bounded length.
+ * */
+class ResultWriter {
+    FILE* out;
+    bool owned;
+    std::vector<char> buffer;
+    size_t used;
+
+    static const size_t buffer_size = 1 << 20;
+    static const size_t line_length = 78;
+
+    void ensure(size_t bytes) {
+        if (used + bytes > buffer.size()) flush();
+    }
+
+    void write(const char* str);
+    void writeInteger(int value); // capacity has to be ensured by the caller
+
+public:
+    /** Write to the given stream (not closed) */
+    ResultWriter(FILE* out_ = stdout);
+
+    /** Write to the given file (check isOpen()) */
+    ResultWriter(const char* filename);
+
+    ~ResultWriter();
+
+    bool isOpen() const {
+        return out != nullptr;
+    }
+
+    void writeStatus(lbool status);
+
+    /** Model values of the variables 0..nVars-1 (variables without value are omitted) */
+    void writeModel(const CandySolverResult& result, unsigned int nVars);
+
+    /** Returns false on write errors */
+    bool flush();
+};
+
+}
+
+#endif
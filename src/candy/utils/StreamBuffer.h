@@ -22,9 +22,29 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <iostream>
 #include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cctype>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <archive.h>
 #include <archive_entry.h>
 
+#if defined(__unix__) || defined(__unix) || defined(unix) || (defined(__APPLE__) && defined(__MACH__))
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define STREAMBUFFER_HAS_MMAP
+#endif
+
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__AVX2__))
+#include <immintrin.h>
+#define STREAMBUFFER_HAS_SIMD
+#endif
+
 class ParserException : public std::exception {
 public:
     explicit ParserException(const std::string& what) noexcept : m_what(what) { }
@@ -36,18 +56,99 @@ private:
     std::string m_what;
 };
 
+/**
+ * StreamBuffer reads (possibly compressed) files through libarchive. 
+ * Uncompressed regular files are memory-mapped instead and parsed in place. 
+ * Compressed files are decompressed by a background thread into a ring of blocks, 
+ * such that decompression and parsing overlap.
+ * */
 class StreamBuffer {
     struct archive* file;
     
-    unsigned int buffer_size;
+    size_t buffer_size;
     char* buffer;
     
-    unsigned int pos; // current read positition
-    unsigned int end; // 1+last valid position
+    size_t pos; // current read positition
+    size_t end; // 1+last valid position
     bool end_of_file; // true when last chunk of file was read to buffer
+    bool mapped; // true if buffer is a read-only mapping of the whole file
+
+    // ring of blocks for background decompression (each block ends with a complete word)
+    struct Block {
+        std::vector<char> data;
+        size_t size;
+        bool last;
+        std::string error; // non-empty if decompression failed after this block
+    };
+    static const size_t ring_size = 3;
+    static const size_t block_size = 1 << 20;
+    std::vector<Block> ring;
+    std::thread producer;
+    std::mutex ring_mutex;
+    std::condition_variable ring_changed;
+    size_t produced; // number of blocks filled by the producer
+    size_t consumed; // number of blocks released by the parser
+    bool stopped;
+
+    std::string read_error() {
+        const char* message = archive_error_string(file);
+        return std::string("Error reading file: ") + (message != nullptr ? message : "unknown error");
+    }
+
+    void produce() {
+        std::vector<char> carry; // incomplete word at the end of the previous block
+        for (size_t i = 0; ; i++) {
+            {
+                std::unique_lock<std::mutex> lock(ring_mutex);
+                ring_changed.wait(lock, [this, i] { return stopped || i - consumed < ring_size; });
+                if (stopped) return;
+            }
+            Block& block = ring[i % ring_size];
+            char* data = block.data.data();
+            std::copy(carry.begin(), carry.end(), data);
+            la_ssize_t count = archive_read_data(file, data + carry.size(), block_size - carry.size());
+            size_t size = carry.size() + std::max<la_ssize_t>(count, 0);
+            block.error = count < 0 ? read_error() : std::string();
+            block.last = count < 0 || size < block_size;
+            block.size = size;
+            if (!block.last) {
+                while (block.size > 0 && !isspace(data[block.size-1])) { // align block with word-end
+                    block.size--;
+                }
+                if (block.size == 0) block.size = size;
+            }
+            carry.assign(data + block.size, data + size);
+            {
+                std::lock_guard<std::mutex> lock(ring_mutex);
+                produced = i + 1;
+            }
+            ring_changed.notify_all();
+            if (block.last) return;
+        }
+    }
+
+    void next_block() {
+        std::unique_lock<std::mutex> lock(ring_mutex);
+        if (buffer != nullptr) {
+            consumed++;
+            ring_changed.notify_all();
+        }
+        ring_changed.wait(lock, [this] { return produced > consumed; });
+        Block& block = ring[consumed % ring_size];
+        if (!block.error.empty()) {
+            throw ParserException(block.error);
+        }
+        buffer = block.data.data();
+        pos = 0;
+        end = block.size;
+        end_of_file = block.last;
+    }
 
     void check_refill_buffer() {
-        if (pos >= end && !end_of_file) {
+        if (pos >= end && !end_of_file && producer.joinable()) {
+            next_block();
+        }
+        else if (pos >= end && !end_of_file) {
             pos = 0;
             if (end > 0 && end < buffer_size) {
                 std::copy(buffer + end, buffer + buffer_size, buffer);
@@ -55,38 +156,158 @@ class StreamBuffer {
             } else {
                 end = 0;
             }
-            end += archive_read_data(file, buffer + end, buffer_size - end);
+            la_ssize_t count = archive_read_data(file, buffer + end, buffer_size - end);
+            if (count < 0) {
+                throw ParserException(read_error());
+            }
+            end += count;
             if (end < buffer_size) {
                 end_of_file = true;
             } else {
-                while (!isspace(buffer[end-1])) {// align buffer with word-end
+                size_t filled = end;
+                while (end > 0 && !isspace(buffer[end-1])) {// align buffer with word-end
                     end--;
                 }
+                if (end == 0) end = filled;
             }
         }
     }
 
+    bool is_uncompressed() {
+        return archive_filter_count(file) == 1 && archive_filter_code(file, 0) == ARCHIVE_FILTER_NONE;
+    }
+
+    bool map_file(const char* filename) {
+#ifdef STREAMBUFFER_HAS_MMAP
+        int fd = open(filename, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // mapping stays valid
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+        buffer = static_cast<char*>(mapping);
+        buffer_size = st.st_size;
+        end = st.st_size;
+        end_of_file = true;
+        mapped = true;
+        return true;
+#else
+        return false;
+#endif
+    }
+
 public:
-    StreamBuffer(const char* filename) : buffer_size(16384), pos(0), end(0), end_of_file(false) {
+    /** Decompression runs on a separate thread unless background is false */
+    StreamBuffer(const char* filename, bool background = true) : file(nullptr), buffer_size(16384), buffer(nullptr), pos(0), end(0), 
+        end_of_file(false), mapped(false), produced(0), consumed(0), stopped(false) {
         file = archive_read_new();
         archive_read_support_filter_all(file);
         archive_read_support_format_raw(file);
         int r = archive_read_open_filename(file, filename, buffer_size);
         if (r != ARCHIVE_OK) {
+            archive_read_free(file);
             throw ParserException(std::string("Error opening file."));
         }
         struct archive_entry *entry;
         r = archive_read_next_header(file, &entry);
         if (r != ARCHIVE_OK) {
+            archive_read_free(file);
             throw ParserException(std::string("Error reading header."));
         }
-        buffer = new char[buffer_size];
-        check_refill_buffer();
+        if (is_uncompressed() && map_file(filename)) {
+            archive_read_free(file);
+            file = nullptr;
+        }
+        else if (background) {
+            ring.resize(ring_size);
+            for (Block& block : ring) {
+                block.data.resize(block_size);
+            }
+            buffer_size = block_size;
+            producer = std::thread(&StreamBuffer::produce, this);
+            try {
+                next_block();
+            } catch (ParserException&) {
+                producer.join(); // producer stops after a failed block
+                archive_read_free(file);
+                throw;
+            }
+        }
+        else {
+            buffer = new char[buffer_size];
+            try {
+                check_refill_buffer();
+            } catch (ParserException&) {
+                archive_read_free(file);
+                delete[] buffer;
+                throw;
+            }
+        }
     }
 
+    /** Read from the given memory range (which is not copied and must outlive the buffer) */
+    StreamBuffer(const char* begin, const char* end_) : file(nullptr), buffer_size(end_ - begin), buffer(const_cast<char*>(begin)), pos(0), end(end_ - begin), 
+        end_of_file(true), mapped(false), produced(0), consumed(0), stopped(false) { }
+
     ~StreamBuffer() {
-        archive_read_free(file);
-        delete[] buffer;
+#ifdef STREAMBUFFER_HAS_MMAP
+        if (mapped) {
+            munmap(buffer, buffer_size);
+        }
+#endif
+        if (producer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(ring_mutex);
+                stopped = true;
+            }
+            ring_changed.notify_all();
+            producer.join();
+            archive_read_free(file);
+        }
+        else if (file != nullptr) {
+            archive_read_free(file);
+            delete[] buffer;
+        }
+    }
+
+    bool isMapped() const {
+        return mapped;
+    }
+
+    /** Unread part of the buffer (in mapped mode this is the remainder of the file) */
+    const char* data() const {
+        return buffer + pos;
+    }
+
+    size_t available() const {
+        return end - pos;
+    }
+
+    /**
+     * Copy the following block of input to 'block'. The block has at least 'size' bytes 
+     * (unless the end of file is reached) and ends with a complete line.
+     * Returns false if there is no more input.
+     * */
+    bool readBlock(std::vector<char>& block, size_t size) {
+        block.clear();
+        while (!eof() && block.size() < size) {
+            block.insert(block.end(), buffer + pos, buffer + end);
+            incPos(end - pos);
+        }
+        while (!eof() && (block.empty() || block.back() != '\n')) {
+            block.push_back(buffer[pos]);
+            incPos(1);
+        }
+        return !block.empty();
     }
 
     /** Skip until the end of the next newline (+subsequent whitespace) */
@@ -98,45 +319,163 @@ public:
     }
 
     void skipWhitespace() {
-        while (!eof() && isspace(buffer[pos])) {
-            incPos(1);
+        while (!eof()) {
+            size_t available = end - pos;
+            size_t count = countRun(buffer + pos, buffer + end, '\t', '\r' - '\t', ' ');
+            incPos(count);
+            if (count < available) break;
         }
     }
 
     /** Skip given sequence of character (+throw exceptions if input deviates) */
     void skipString(const char* str) {
         for (; *str != '\0'; ++str, incPos(1)) {
-            if (*str != buffer[pos] || eof()) {
-                throw ParserException(std::string("PARSE ERROR! Expected '") + std::string(str) + std::string("' but found ") + std::string(1, buffer[pos]));
+            if (eof() || *str != buffer[pos]) {
+                throw ParserException(std::string("PARSE ERROR! Expected '") + std::string(str) + std::string("' but found ") + (eof() ? std::string("EOF") : std::string(1, buffer[pos])));
             }
         }
     }
 
+    /** 
+     * Parse a decimal integer without reading past the end of valid data 
+     * (the buffer might be a mapping which is not null-terminated). 
+     * Whitespace following the integer might be skipped as well. 
+     * */
     int readInteger() {
+#if defined(STREAMBUFFER_HAS_SIMD) && defined(__SSE4_1__)
+        if (end - pos >= 16) {
+            int number;
+            size_t length = readIntegerBlock(buffer + pos, number);
+            if (length > 0) {
+                incPos(length);
+                return number;
+            }
+        }
+#endif
         skipWhitespace();
         if (eof()) return 0; //throw ParserException(std::string("PARSE ERROR! Unexpected end of file"));
 
-        char* str = buffer + pos;
-        char* end = NULL;
-                
-        errno = 0;
-        long number = strtol(str, &end, 10);
+        const char* str = buffer + pos;
+        const char* it = str;
+        const char* last = buffer + end;
 
-        if (errno == ERANGE || 2*labs(number) >= std::numeric_limits<uint32_t>::max()) {
-            throw ParserException(std::string("PARSE ERROR! Variable out of supported range (32 bits): ") + std::to_string(number));
+        bool negative = *it == '-';
+        if (negative || *it == '+') {
+            ++it;
         }
-        else if (errno != 0) {
-            // Had ERRNO=25 ('Not a typewriter') when acceptance tests are run from gTest
-            // Had ERRNO=29 ('Illegal seek') when reading from stdin
-            throw ParserException(std::string("PARSE ERROR! In 'strtol()', errno ") + std::to_string(errno) + std::string(" while reading ") + std::string(1, buffer[pos]));
+        if (it == last || !isdigit(*it)) {
+            throw ParserException(std::string("PARSE ERROR! Unexpected character ") + std::string(1, buffer[pos]));
         }
-        else if (end > str) {
-            incPos(static_cast<intptr_t>(end - str));
-            return static_cast<int>(number);
+
+        uint64_t number = 0;
+        for (; it != last && isdigit(*it); ++it) {
+            number = number * 10 + (*it - '0');
+            if (number > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+                throw ParserException(std::string("PARSE ERROR! Variable out of supported range (32 bits): ") + std::string(str, it+1));
+            }
         }
-        else {
-            throw ParserException(std::string("PARSE ERROR! Unexpected character ") + std::string(1, buffer[pos]));
+
+        incPos(static_cast<size_t>(it - str));
+        return negative ? -static_cast<int>(number) : static_cast<int>(number);
+    }
+
+private:
+#if defined(STREAMBUFFER_HAS_SIMD)
+    /** Bitmask of the characters c in the block with c == extra or lo <= c <= lo + width */
+    static uint32_t classify(__m128i chars, char lo, char width, char extra) {
+        __m128i offset = _mm_sub_epi8(chars, _mm_set1_epi8(lo));
+        __m128i match = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(extra)), _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(width)), offset));
+        return static_cast<uint32_t>(_mm_movemask_epi8(match));
+    }
+#endif
+
+    /**
+     * Length of the run of characters c in [begin, last) with c == extra or lo <= c <= lo + width.
+     * Long runs are classified in blocks of 32 (AVX2) or 16 (SSE2) characters.
+     * */
+    static size_t countRun(const char* begin, const char* last, char lo, char width, char extra) {
+        const char* it = begin;
+        if (it == last || !(*it == extra || static_cast<unsigned char>(*it - lo) <= static_cast<unsigned char>(width))) {
+            return 0;
+        }
+#if defined(STREAMBUFFER_HAS_SIMD) && defined(__AVX2__)
+        const __m256i lo32 = _mm256_set1_epi8(lo), width32 = _mm256_set1_epi8(width), extra32 = _mm256_set1_epi8(extra);
+        for (; it + 32 <= last; it += 32) {
+            __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+            __m256i offset = _mm256_sub_epi8(chars, lo32);
+            __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(chars, extra32), _mm256_cmpeq_epi8(_mm256_min_epu8(offset, width32), offset));
+            uint32_t mismatch = ~static_cast<uint32_t>(_mm256_movemask_epi8(match));
+            if (mismatch != 0) {
+                return it - begin + __builtin_ctz(mismatch);
+            }
+        }
+#endif
+#if defined(STREAMBUFFER_HAS_SIMD)
+        for (; it + 16 <= last; it += 16) {
+            uint32_t mismatch = ~classify(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it)), lo, width, extra) & 0xFFFF;
+            if (mismatch != 0) {
+                return it - begin + __builtin_ctz(mismatch);
+            }
+        }
+#endif
+        for (; it != last && (*it == extra || static_cast<unsigned char>(*it - lo) <= static_cast<unsigned char>(width)); ++it);
+        return it - begin;
+    }
+
+#if defined(STREAMBUFFER_HAS_SIMD) && defined(__SSE4_1__)
+    /**
+     * Parse an integer of at most 9 digits (and the surrounding whitespace) from the 16 characters at str 
+     * by classifying and converting the whole block at once. Returns the number of characters consumed, 
+     * or 0 if the integer is not fully contained in the block (or malformed) and needs the general parser.
+     * */
+    static size_t readIntegerBlock(const char* str, int& number) {
+        // shuffle masks: shift the block left by n (at n), right-align the first n characters (at 16 + n)
+        static const int8_t masks[48] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str));
+        uint32_t nonspace = ~classify(chars, '\t', '\r' - '\t', ' ');
+        uint32_t nondigit = ~classify(chars, '0', 9, '0');
+
+        uint32_t first = __builtin_ctz(nonspace);
+        if (first == 16) return 0;
+        bool negative = str[first] == '-';
+        if (negative || str[first] == '+') {
+            ++first;
+        }
+        uint32_t length = __builtin_ctz(nondigit >> first);
+        if (length == 0 || length > 9 || first + length == 16) return 0;
+        uint32_t last = first + length;
+
+        __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+        digits = _mm_shuffle_epi8(digits, _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + first)));
+        digits = _mm_shuffle_epi8(digits, _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + 16 + length)));
+        __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+        __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+        quads = _mm_packus_epi32(quads, quads);
+        __m128i octets = _mm_madd_epi16(quads, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+        int value = _mm_cvtsi128_si32(octets) * 100000000 + _mm_extract_epi32(octets, 1);
+
+        number = negative ? -value : value;
+        return last + __builtin_ctz(nonspace >> last);
+    }
+#endif
+
+public:
+    /** 
+     * Read an unsigned integer in the variable-length encoding of binary DRAT 
+     * (7 bits per byte, least significant first, high bit set if more bytes follow).
+     * */
+    uint64_t readVarint() {
+        uint64_t number = 0;
+        for (unsigned int shift = 0; !eof() && shift < 64; shift += 7) {
+            unsigned char byte = static_cast<unsigned char>(buffer[pos]);
+            incPos(1);
+            number |= static_cast<uint64_t>(byte & 127) << shift;
+            if (byte < 128) break;
         }
+        return number;
     }
 
     int operator *() const {
@@ -147,7 +486,7 @@ public:
         incPos(1);
     }
 
-    void incPos(unsigned int inc) {
+    void incPos(size_t inc) {
         pos += inc;
         check_refill_buffer();
     }
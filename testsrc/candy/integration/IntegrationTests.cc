@@ -31,6 +31,10 @@
 #include <candy/core/DRATChecker.h>
 #include <candy/core/CandySolverInterface.h>
 #include <candy/core/clauses/ClauseDatabase.h>
+#include <candy/core/clauses/ClauseArena.h>
+#include <candy/mtl/HugePages.h>
+#include <candy/simplification/OccurenceList.h>
+#include <candy/simplification/VariableElimination.h>
 #include <candy/utils/CandyBuilder.h>
 
 extern "C" {
@@ -39,6 +43,11 @@ extern "C" {
 
 #include <iostream>
 #include <algorithm>
+#include <fstream>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
 
 #define GTEST_COUT std::cerr << "[ INFO     ] "
 
@@ -105,6 +114,34 @@ namespace Candy {
         acceptanceTest("cnf/dd4.cnf", static_allocator);
     }
 
+    /**
+     * Solves the problems with VSIDS and the given proof options and checks the proofs, 
+     * the default proof options are restored afterwards
+     * */
+    static void proofTest(const char* cert, bool binary, bool async, bool lrat, bool backward = true, int threads = 1) {
+        SolverOptions::opt_use_lrb = false;
+        ParallelOptions::opt_static_propagate = false;
+        ParallelOptions::opt_lb_propagate = false;
+        ParallelOptions::opt_3full_propagate = false;
+        ParallelOptions::opt_Xfull_propagate = 2;
+        Stability::opt_prop_by_stability = false;
+        CERT = cert;
+        SolverOptions::opt_certified_binary = binary;
+        SolverOptions::opt_certified_async = async;
+        SolverOptions::opt_certified_lrat = lrat;
+        TestingOptions::test_proof_backward = backward;
+        TestingOptions::test_proof_threads = threads;
+        testTrivialProblems(false);
+        testRealProblems(false);
+        testFixedBugs(false);
+        CERT = "cert.drat";
+        SolverOptions::opt_certified_binary = false;
+        SolverOptions::opt_certified_async = false;
+        SolverOptions::opt_certified_lrat = false;
+        TestingOptions::test_proof_backward = true;
+        TestingOptions::test_proof_threads = 1;
+    }
+
     TEST(IntegrationTest, test_vsids) {
         SolverOptions::opt_use_lrb = false;
         ParallelOptions::opt_static_propagate = false;
@@ -118,6 +155,270 @@ namespace Candy {
         testFixedBugs(false);
     }
 
+    TEST(IntegrationTest, test_vsids_with_binary_proof) {
+        proofTest("cert.drat", true, false, false);
+    }
+
+    TEST(IntegrationTest, test_vsids_with_async_proof) {
+        proofTest("cert.drat", false, true, false);
+    }
+
+    TEST(IntegrationTest, test_vsids_with_compressed_proof) {
+        proofTest("cert.drat.gz", true, true, false);
+    }
+
+    TEST(IntegrationTest, test_vsids_with_lrat_proof) {
+        proofTest("cert.lrat", false, false, true);
+    }
+
+    TEST(IntegrationTest, test_vsids_with_forward_proof_check) {
+        proofTest("cert.drat", false, false, false, false);
+    }
+
+    TEST(IntegrationTest, test_vsids_with_parallel_proof_check) {
+        proofTest("cert.drat", false, false, false, true, 4);
+    }
+
+#ifdef __unix__
+    TEST(IntegrationTest, test_proof_write_errors_are_detected) {
+        std::vector<Lit> clause { Lit(0, 0), Lit(1, 1) };
+        for (const char* filename : { "full.drat", "full.drat.gz" }) {
+            std::remove(filename);
+            ASSERT_EQ(symlink("/dev/full", filename), 0);
+            Certificate certificate(filename, false, false);
+            for (int i = 0; i < 100000; i++) {
+                certificate.added(clause.begin(), clause.end());
+            }
+            certificate.proof();
+            EXPECT_FALSE(certificate.good());
+            std::remove(filename);
+        }
+        Certificate certificate(CERT, false, true);
+        certificate.added(clause.begin(), clause.end());
+        certificate.proof();
+        EXPECT_TRUE(certificate.good());
+    }
+#endif
+
+    TEST(IntegrationTest, test_vsids_with_incremental_defragmentation) {
+        SolverOptions::opt_use_lrb = false;
+        ParallelOptions::opt_static_propagate = false;
+        ParallelOptions::opt_lb_propagate = false;
+        ParallelOptions::opt_3full_propagate = false;
+        ParallelOptions::opt_Xfull_propagate = 2;
+        Stability::opt_prop_by_stability = false;
+        ClauseDatabaseOptions::opt_defrag_pages = 1;
+        testTrivialProblems(false);
+        testRealProblems(false);
+        testFixedBugs(false);
+        ParallelOptions::opt_3full_propagate = true;
+        testRealProblems(false);
+        ParallelOptions::opt_3full_propagate = false;
+        ClauseDatabaseOptions::opt_defrag_pages = 0;
+    }
+
+    TEST(IntegrationTest, test_vsids_with_reorganize_by_watches) {
+        ClauseDatabaseOptions::opt_reorganize_by_watches = true;
+        ClauseDatabaseOptions::opt_reorganize_threshold = 0; // relocate on every reduce
+        ClauseDatabaseOptions::opt_first_reduce_db = 100; // reduce (and reorganize) often on small problems
+        ClauseDatabaseOptions::opt_inc_reduce_db = 50;
+        proofTest("cert.drat", false, false, false);
+        proofTest("cert.lrat", false, false, true);
+        testFuzzProblems(false);
+        acceptanceTest("cnf/sat100.cnf", false); // reorganized before the model is found
+        acceptanceTest("cnf/6s33.cnf", false);
+        ParallelOptions::opt_3full_propagate = true;
+        testRealProblems(false);
+        ParallelOptions::opt_3full_propagate = false;
+        ClauseDatabaseOptions::opt_reorganize_by_watches = false;
+        ClauseDatabaseOptions::opt_reorganize_threshold = 20;
+        ClauseDatabaseOptions::opt_first_reduce_db = 3000;
+        ClauseDatabaseOptions::opt_inc_reduce_db = 1300;
+    }
+
+    TEST(IntegrationTest, test_vsids_with_reuse_of_deleted_clauses) {
+        ClauseDatabaseOptions::opt_first_reduce_db = 100; // reduce often on small problems
+        ClauseDatabaseOptions::opt_inc_reduce_db = 50;
+        for (int pages : { 0, 1 }) { // reuse after reduce, and after the sweep of incremental defragmentation
+            ClauseDatabaseOptions::opt_defrag_pages = pages;
+            ClauseDatabaseOptions::opt_reorganize_threshold = 100; // never defragment completely
+            proofTest("cert.drat", false, false, false);
+            proofTest("cert.lrat", false, false, true);
+            acceptanceTest("cnf/sat100.cnf", false);
+            acceptanceTest("cnf/6s33.cnf", false);
+            ClauseDatabaseOptions::opt_reorganize_threshold = 30;
+            proofTest("cert.drat", false, false, false);
+        }
+        ClauseDatabaseOptions::opt_defrag_pages = 0;
+        ClauseDatabaseOptions::opt_reorganize_threshold = 20;
+        ClauseDatabaseOptions::opt_first_reduce_db = 3000;
+        ClauseDatabaseOptions::opt_inc_reduce_db = 1300;
+    }
+
+    TEST(IntegrationTest, test_proof_checker_rejects_invalid_lemmas) {
+        CNFProblem problem;
+        problem.readDimacsFromFile("cnf/hole6.cnf");
+        SolverOptions::opt_certified_file = "";
+        std::ofstream proof(CERT);
+        proof << "1 0" << std::endl << "-1 0" << std::endl << "0" << std::endl;
+        proof.close();
+        for (bool backward : { true, false }) {
+            TestingOptions::test_proof_backward = backward;
+            DRATChecker checker(problem);
+            ASSERT_FALSE(checker.check_proof(CERT));
+        }
+        TestingOptions::test_proof_backward = true;
+        TestingOptions::test_proof_threads = 2;
+        ASSERT_FALSE(DRATChecker(problem).check_proof(CERT));
+        TestingOptions::test_proof_threads = 1;
+        proof.open(CERT);
+        proof << "134 1 0 5 0" << std::endl << "135 -1 0 3 0" << std::endl << "136 0 134 135 0" << std::endl;
+        proof.close();
+        DRATChecker checker(problem);
+        ASSERT_FALSE(checker.check_proof(CERT));
+    }
+
+    static bool checkProof(CNFProblem& problem, const char* proof, bool backward, int threads) {
+        std::ofstream out(CERT);
+        out << proof;
+        out.close();
+        TestingOptions::test_proof_backward = backward;
+        TestingOptions::test_proof_threads = threads;
+        bool proved = DRATChecker(problem).check_proof(CERT);
+        TestingOptions::test_proof_backward = true;
+        TestingOptions::test_proof_threads = 1;
+        return proved;
+    }
+
+    TEST(IntegrationTest, test_proof_checker_deletions) {
+        SolverOptions::opt_certified_file = "";
+        CNFProblem problem { {Lit(0, 0), Lit(1, 0)}, {Lit(0, 1), Lit(1, 0)}, {Lit(0, 0), Lit(1, 1)}, {Lit(0, 1), Lit(1, 1)} };
+        CNFProblem duplicates { {Lit(0, 0), Lit(1, 0)}, {Lit(0, 0), Lit(1, 0)}, {Lit(0, 1), Lit(1, 0)}, {Lit(0, 0), Lit(1, 1)}, {Lit(0, 1), Lit(1, 1)} };
+        for (bool backward : { true, false }) {
+            for (int threads : { 1, 2 }) {
+                if (!backward && threads > 1) continue;
+                GTEST_COUT << (threads > 1 ? "parallel" : backward ? "backward" : "forward") << std::endl;
+                ASSERT_TRUE(checkProof(problem, "2 0\n0\n", backward, threads));
+                // deletions are matched regardless of the order of literals
+                ASSERT_FALSE(checkProof(problem, "d 2 1 0\n2 0\n0\n", backward, threads));
+                // deletions of unknown clauses are ignored
+                ASSERT_TRUE(checkProof(problem, "d 1 -1 0\nd 2 3 0\n2 0\n0\n", backward, threads));
+                // a deletion removes one copy of a duplicate clause
+                ASSERT_TRUE(checkProof(duplicates, "d 2 1 0\n2 0\n0\n", backward, threads));
+                ASSERT_FALSE(checkProof(duplicates, "d 2 1 0\nd 1 2 0\n2 0\n0\n", backward, threads));
+            }
+        }
+    }
+
+    TEST(IntegrationTest, test_proof_checker_lrat_hints) {
+        SolverOptions::opt_certified_file = "";
+        CNFProblem problem { {Lit(0, 0), Lit(0, 1)}, {Lit(0, 0), Lit(1, 0)}, {Lit(0, 1), Lit(1, 0)}, {Lit(0, 0), Lit(1, 1)}, {Lit(0, 1), Lit(1, 1)} };
+        // the tautology is dropped but keeps its id, the other clauses have ids 2 to 5
+        ASSERT_TRUE(checkProof(problem, "6 2 0 2 3 0\n7 0 6 4 5 0\n", true, 1));
+        ASSERT_FALSE(checkProof(problem, "5 2 0 1 2 0\n6 0 5 3 4 0\n", true, 1));
+        // lemmas which are implied by unit propagation, but not by their hints
+        ASSERT_FALSE(checkProof(problem, "6 2 0 2 4 0\n7 0 6 4 5 0\n", true, 1));
+        ASSERT_FALSE(checkProof(problem, "6 2 0 2 3 0\n7 0 6 4 0\n", true, 1));
+        ASSERT_FALSE(checkProof(problem, "6 2 0 0\n7 0 6 4 5 0\n", true, 1));
+        // hints must not refer to deleted clauses
+        ASSERT_FALSE(checkProof(problem, "5 d 3 0\n6 2 0 2 3 0\n7 0 6 4 5 0\n", true, 1));
+    }
+
+    TEST(IntegrationTest, test_proof_of_restored_eliminated_clauses) {
+        SolverOptions::opt_certified_file = "elim.lrat";
+        SolverOptions::opt_certified_lrat = true;
+        CNFProblem problem { {Lit(0, 0), Lit(1, 0)}, {Lit(0, 1), Lit(1, 0)}, {Lit(0, 0), Lit(1, 1)}, {Lit(0, 1), Lit(1, 1)} };
+        {
+            ClauseDatabase database(problem);
+            Trail trail(problem);
+            trail.setDecisionVar(1, false); // eliminate only the first variable
+            OccurenceList occurences(database);
+            VariableElimination elimination(database, trail);
+            elimination.eliminate(occurences);
+            ASSERT_TRUE(elimination.is_eliminated(0));
+            elimination.undo(0); // the restored clauses are derived from the eliminated ones, which stay in the proof
+            std::map<std::vector<Lit>, uint32_t> ids; // the latest clause by literals
+            for (Clause* clause : database) {
+                if (!clause->isDeleted()) ids[std::vector<Lit>(clause->begin(), clause->end())] = clause->id();
+            }
+            std::vector<Lit> y { Lit(1, 0) }, x_or_not_y { Lit(0, 0), Lit(1, 1) }, not_x_or_not_y { Lit(0, 1), Lit(1, 1) };
+            ASSERT_EQ(ids.size(), 6ul);
+            ASSERT_GT(ids[x_or_not_y], 6u);
+            ASSERT_GT(ids[not_x_or_not_y], 6u);
+            database.emptyClause({ ids[y], ids[x_or_not_y], ids[not_x_or_not_y] }); // the resolvent and restored clauses
+        }
+        SolverOptions::opt_certified_file = "";
+        SolverOptions::opt_certified_lrat = false;
+        ASSERT_TRUE(DRATChecker(problem).check_proof("elim.lrat"));
+        std::remove("elim.lrat");
+    }
+
+    TEST(IntegrationTest, test_vsids_with_huge_pages) {
+        for (int mode : { 1, 2 }) { // mode 2 falls back to transparent huge pages if the pool is empty
+            SolverOptions::opt_huge_pages = mode;
+            proofTest("cert.drat", false, false, false);
+            ParallelOptions::opt_3full_propagate = true;
+            testRealProblems(false);
+            ParallelOptions::opt_3full_propagate = false;
+        }
+        SolverOptions::opt_huge_pages = 0;
+    }
+
+    /**
+     * Three copies of 6s33 over disjoint variables need more conflicts than a quarter, but less than all 
+     * of the reduce interval, so they are only reduced early under memory pressure. The reduce is tighter, 
+     * the clause memory is compacted and the lists of the propagator are shrunk. With a limit of 2 MB the 
+     * solver stays below the limit, with 1 MB the copies alone exceed it and the solver gives up.
+     * */
+    static void memoryLimitTest(int limit, lbool expected) {
+        CNFProblem original;
+        original.readDimacsFromFile("cnf/6s33.cnf");
+        CNFProblem problem;
+        for (unsigned int copy = 0; copy < 3; copy++) {
+            for (const auto& clause : original) {
+                std::vector<Lit> literals;
+                for (Lit lit : clause) {
+                    literals.push_back(Lit(lit.var() + copy * original.nVars(), lit.sign()));
+                }
+                problem.readClause(literals.begin(), literals.end());
+            }
+        }
+        size_t clauses = ClauseArena::used();
+        size_t lists = HugePages::allocated();
+        SolverOptions::memory_limit = limit;
+        CandySolverInterface* solver = createSolver(problem);
+        testing::internal::CaptureStdout();
+        lbool result = solver->solve();
+        std::string output = testing::internal::GetCapturedStdout();
+        delete solver;
+        SolverOptions::memory_limit = 0;
+        ASSERT_TRUE(result == expected);
+        ASSERT_NE(output.find("c Reducing under memory pressure"), std::string::npos);
+        ASSERT_EQ(output.find("c Memory limit exceeded") != std::string::npos, expected == l_Undef);
+        ASSERT_EQ(ClauseArena::used(), clauses);
+        ASSERT_EQ(HugePages::allocated(), lists);
+    }
+
+    TEST(IntegrationTest, test_vsids_with_memory_limit) {
+        SolverOptions::opt_use_lrb = false;
+        ParallelOptions::opt_Xfull_propagate = 2;
+        SolverOptions::opt_certified_file = "";
+        ClauseDatabaseOptions::opt_first_reduce_db = 8000;
+        for (int propagator = 0; propagator < 5; propagator++) {
+            ParallelOptions::opt_static_propagate = propagator == 1;
+            ParallelOptions::opt_lb_propagate = propagator == 2;
+            ParallelOptions::opt_3full_propagate = propagator == 3;
+            Stability::opt_prop_by_stability = propagator == 4;
+            memoryLimitTest(2, l_False);
+            memoryLimitTest(1, l_Undef);
+        }
+        ParallelOptions::opt_static_propagate = false;
+        ParallelOptions::opt_lb_propagate = false;
+        ParallelOptions::opt_3full_propagate = false;
+        Stability::opt_prop_by_stability = false;
+        ClauseDatabaseOptions::opt_first_reduce_db = 3000;
+    }
+
     TEST(IntegrationTest, test_vsids_with_static_propagate) {
         SolverOptions::opt_use_lrb = false;
         ParallelOptions::opt_static_propagate = true;
@@ -54,8 +54,8 @@ namespace Candy {
         bool found = false;
         Cl clause1(clause.begin(), clause.end());
         std::sort(clause1.begin(), clause1.end());
-        for (auto fcl : formula) {
-            Cl clause2(fcl->begin(), fcl->end());
+        for (CNFClause fcl : formula) {
+            Cl clause2(fcl.begin(), fcl.end());
             std::sort(clause2.begin(), clause2.end());
             found |= (clause1 == clause2);
         }
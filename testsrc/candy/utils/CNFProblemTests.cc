@@ -3,12 +3,16 @@
 #include <string>
 #include <fstream>
 #include <streambuf>
+#include <type_traits>
+#include <utility>
 
 #include "gtest/gtest.h"
 
 #include "candy/testutils/TestUtils.h"
 #include "candy/core/SolverTypes.h"
 #include "candy/core/CNFProblem.h"
+#include "candy/core/CandySolverResult.h"
+#include "candy/utils/StreamBuffer.h"
 
 using namespace Candy;
 
@@ -31,3 +35,265 @@ TEST (CNFProblemTestPatterns, tautologicClauseRemoval) {
     ASSERT_EQ(problem.nClauses(), 0);
 }
 
+TEST (CNFProblemTestPatterns, droppedClausePositions) {
+    const char* filename = "cnfproblem_dropped.cnf";
+    std::ofstream out(filename);
+    std::vector<uint64_t> expected;
+    std::srand(4);
+    for (uint64_t i = 0; i < 300000; i++) { // spans several parser chunks
+        if (i == 0 || i % 9973 == 0 || i == 299999) {
+            out << "3 -1 -3 0\n";
+            expected.push_back(i);
+        } else {
+            out << std::rand() % 1000 + 1 << " -" << std::rand() % 1000 + 1001 << " 0\n";
+        }
+    }
+    out.close();
+    for (unsigned int threads : { 1, 4 }) {
+        CNFProblem problem;
+        problem.readDimacsFromFile(filename, threads);
+        EXPECT_EQ(problem.droppedClauses(), expected);
+        EXPECT_EQ(problem.nClauses() + expected.size(), 300000ul);
+    }
+    CNFProblem streamed;
+    streamed.openDimacsStream(filename);
+    streamed.streamClauses([](Lit*, Lit*) { });
+    EXPECT_EQ(streamed.droppedClauses(), expected);
+    CNFProblem problem;
+    problem.readDimacsFromFile(filename);
+    std::remove(filename);
+    const char* binary = "cnfproblem_dropped.bcnf";
+    ASSERT_TRUE(problem.writeBinary(binary));
+    CNFProblem copy;
+    ASSERT_TRUE(copy.readBinary(binary));
+    std::remove(binary);
+    EXPECT_EQ(copy.droppedClauses(), expected);
+}
+
+TEST (CNFProblemTestPatterns, randomAccessIteration) {
+    CNFProblem problem { {Lit(0, 0)}, {Lit(1, 0), Lit(2, 0)}, {Lit(3, 1), Lit(4, 0), Lit(5, 0)} };
+    CNFProblem::const_iterator begin = problem.begin(), end = problem.end();
+    ASSERT_EQ(std::distance(begin, end), 3);
+    ASSERT_TRUE(begin < end);
+    ASSERT_EQ((*(end - 1)).size(), 3u);
+    ASSERT_TRUE(begin[1] == problem[1]);
+    ASSERT_TRUE(*std::prev(end) == problem[2]);
+    std::vector<size_t> sizes;
+    for (CNFProblem::const_iterator it = end; it != begin; ) {
+        sizes.push_back((*--it).size());
+    }
+    ASSERT_EQ(sizes, std::vector<size_t>({ 3, 2, 1 }));
+}
+
+
+TEST (CNFProblemTestPatterns, readDimacsWithoutTrailingNewline) {
+    const char* filename = "cnfproblem_no_newline.cnf";
+    std::ofstream out(filename);
+    out << "c comment\np cnf 3 2\n1 -2 0\n-3 2 0";
+    out.close();
+    CNFProblem problem;
+    problem.readDimacsFromFile(filename);
+    std::remove(filename);
+    ASSERT_EQ(problem.nClauses(), 2ul);
+    ASSERT_EQ(problem.nVars(), 3ul);
+    EXPECT_TRUE(containsClause(problem, {Lit(0, 0), Lit(1, 1)}));
+    EXPECT_TRUE(containsClause(problem, {Lit(2, 1), Lit(1, 0)}));
+}
+
+TEST (CNFProblemTestPatterns, parallelParsingPreservesClauseOrder) {
+    const char* filename = "cnfproblem_parallel.cnf";
+    std::ofstream out(filename);
+    out << "p cnf 1000 100000\n";
+    std::srand(1);
+    for (int i = 0; i < 100000; i++) {
+        if (i % 1000 == 0) out << "c comment 1 2 0\n";
+        for (int j = 0; j < 1 + i % 7; j++) { // clauses span several lines
+            out << (std::rand() % 1000 + 1) * (std::rand() % 2 ? 1 : -1) << (j % 3 == 2 ? "\n" : " ");
+        }
+        out << "0\n";
+    }
+    out.close();
+    CNFProblem sequential;
+    sequential.readDimacsFromFile(filename, 1);
+    CNFProblem parallel;
+    parallel.readDimacsFromFile(filename, 4);
+    std::remove(filename);
+    ASSERT_EQ(sequential.nVars(), parallel.nVars());
+    ASSERT_EQ(sequential.nClauses(), parallel.nClauses());
+    for (size_t i = 0; i < sequential.nClauses(); i++) {
+        ASSERT_TRUE(sequential[i] == parallel[i]);
+    }
+}
+
+TEST (CNFProblemTestPatterns, binaryRoundTrip) {
+    const char* filename = "cnfproblem_roundtrip.bcnf";
+    CNFProblem problem { {Lit(0, 0), Lit(1, 1)}, {Lit(2, 1)}, {} };
+    ASSERT_TRUE(problem.writeBinary(filename));
+    CNFProblem copy;
+    ASSERT_TRUE(copy.readBinary(filename));
+    std::remove(filename);
+    ASSERT_EQ(copy.nVars(), problem.nVars());
+    ASSERT_EQ(copy.nClauses(), problem.nClauses());
+    for (size_t i = 0; i < problem.nClauses(); i++) {
+        EXPECT_TRUE(copy[i] == problem[i]);
+    }
+    EXPECT_FALSE(copy.readBinary(filename));
+    EXPECT_EQ(copy.nClauses(), 0ul);
+}
+
+TEST (CNFProblemTestPatterns, binaryRejectsOverflowingHeader) {
+    const char* filename = "cnfproblem_overflow.bcnf";
+    CNFProblem problem { {Lit(0, 0), Lit(1, 1)}, {Lit(2, 1)} };
+    ASSERT_TRUE(problem.writeBinary(filename));
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    // counts chosen such that (clauses+1)*8 + literals*4 wraps around to the real payload size
+    uint64_t clauses = (1ull << 61) + 2, literals = 3;
+    file.seekp(16);
+    file.write(reinterpret_cast<const char*>(&clauses), sizeof(clauses));
+    file.write(reinterpret_cast<const char*>(&literals), sizeof(literals));
+    file.close();
+    CNFProblem copy;
+    EXPECT_FALSE(copy.readBinary(filename));
+    EXPECT_EQ(copy.nClauses(), 0ul);
+    std::remove(filename);
+}
+
+TEST (CNFProblemTestPatterns, streamingModelCheck) {
+    const char* filename = "cnfproblem_model.cnf";
+    std::ofstream out(filename);
+    out << "p cnf 3 3\n1 -2 0\n-3 2 0\n3 -3 0";
+    out.close();
+    CandySolverResult model { Lit(0, 0), Lit(1, 0), Lit(2, 1) };
+    CandySolverResult counter { Lit(0, 1), Lit(1, 0), Lit(2, 1) };
+    EXPECT_TRUE(CNFProblem::checkResult(filename, model));
+    EXPECT_FALSE(CNFProblem::checkResult(filename, counter));
+    std::remove(filename);
+}
+
+TEST (CNFProblemTestPatterns, readDimacsNumberFormats) {
+    const char* filename = "cnfproblem_numbers.cnf";
+    std::ofstream out(filename);
+    out << "p cnf 20 2\r\n\t+1  -000000000000000000002\t0\r\n"
+        << "                                        20 -3 0\n";
+    out.close();
+    CNFProblem problem;
+    problem.readDimacsFromFile(filename);
+    EXPECT_EQ(problem.nClauses(), 2ul);
+    EXPECT_EQ(problem.nVars(), 20ul);
+    EXPECT_TRUE(containsClause(problem, {Lit(0, 0), Lit(1, 1)}));
+    EXPECT_TRUE(containsClause(problem, {Lit(19, 0), Lit(2, 1)}));
+
+    out.open(filename);
+    out << "p cnf 1 1\n2147483648 0\n";
+    out.close();
+    CNFProblem overflow;
+    EXPECT_THROW(overflow.readDimacsFromFile(filename), ParserException);
+    std::remove(filename);
+}
+
+static void writeGzip(const char* filename, const std::string& content) {
+    struct archive* out = archive_write_new();
+    archive_write_add_filter_gzip(out);
+    archive_write_set_format_raw(out);
+    archive_write_open_filename(out, filename);
+    struct archive_entry* entry = archive_entry_new();
+    archive_entry_set_filetype(entry, AE_IFREG);
+    archive_write_header(out, entry);
+    archive_write_data(out, content.data(), content.size());
+    archive_entry_free(entry);
+    archive_write_free(out);
+}
+
+TEST (CNFProblemTestPatterns, compressedInputMatchesPlainInput) {
+    const char* plain = "cnfproblem_compressed.cnf";
+    const char* compressed = "cnfproblem_compressed.cnf.gz";
+    std::string content;
+    std::srand(2);
+    for (int i = 0; i < 400000; i++) { // spans several decompression blocks
+        for (int j = 0; j < 1 + i % 5; j++) {
+            content += std::to_string((std::rand() % 5000 + 1) * (std::rand() % 2 ? 1 : -1)) + " ";
+        }
+        content += "0\n";
+    }
+    std::ofstream out(plain);
+    out << content;
+    out.close();
+    writeGzip(compressed, content);
+    CNFProblem expected;
+    expected.readDimacsFromFile(plain);
+    CNFProblem problem;
+    problem.readDimacsFromFile(compressed);
+    std::remove(plain);
+    std::remove(compressed);
+    ASSERT_EQ(expected.nVars(), problem.nVars());
+    ASSERT_EQ(expected.nClauses(), problem.nClauses());
+    for (size_t i = 0; i < problem.nClauses(); i++) {
+        ASSERT_TRUE(expected[i] == problem[i]);
+    }
+}
+
+TEST (CNFProblemTestPatterns, truncatedCompressedInputIsRejected) {
+    const char* compressed = "cnfproblem_truncated.cnf.gz";
+    std::string content;
+    std::srand(3);
+    for (int i = 0; i < 400000; i++) {
+        content += std::to_string(std::rand() % 5000 + 1) + " -" + std::to_string(std::rand() % 5000 + 1) + " 0\n";
+    }
+    writeGzip(compressed, content);
+    std::ifstream in(compressed, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(compressed, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size() / 2);
+    out.close();
+    CNFProblem problem;
+    EXPECT_THROW(problem.readDimacsFromFile(compressed), ParserException);
+    EXPECT_THROW({
+        StreamBuffer unthreaded(compressed, false);
+        while (!unthreaded.eof()) unthreaded.skipLine();
+    }, ParserException);
+    std::remove(compressed);
+}
+
+TEST (CNFProblemTestPatterns, streamedClausesAreNormalized) {
+    const char* filename = "cnfproblem_stream.cnf";
+    std::ofstream out(filename);
+    out << "c comment\np cnf 2 3\n2 1 2 0\n1 -1 0\n-5 1 0\n";
+    out.close();
+    CNFProblem stored;
+    stored.readDimacsFromFile(filename);
+    CNFProblem streamed;
+    streamed.openDimacsStream(filename);
+    EXPECT_TRUE(streamed.isStreamed());
+    EXPECT_EQ(streamed.nClauses(), 0ul);
+    EXPECT_EQ(streamed.nVars(), 2ul);
+    std::vector<Cl> clauses;
+    streamed.streamClauses([&clauses](Lit* begin, Lit* end) { clauses.emplace_back(begin, end); });
+    std::remove(filename);
+    EXPECT_EQ(streamed.nVars(), 5ul);
+    ASSERT_EQ(clauses.size(), stored.nClauses());
+    for (size_t i = 0; i < clauses.size(); i++) {
+        EXPECT_TRUE(clauses[i] == Cl(stored[i].begin(), stored[i].end()));
+    }
+}
+
+TEST (CNFProblemTestPatterns, fingerprintIsOrderIndependent) {
+    CNFProblem problem { {Lit(0, 0), Lit(1, 1)}, {Lit(2, 1), Lit(0, 1), Lit(3, 0)}, {Lit(1, 0)} };
+    CNFProblem permuted { {Lit(1, 0)}, {Lit(3, 0), Lit(2, 1), Lit(0, 1)}, {Lit(1, 1), Lit(0, 0)} };
+    CNFProblem different { {Lit(0, 0), Lit(1, 1)}, {Lit(2, 1), Lit(0, 1), Lit(3, 1)}, {Lit(1, 0)} };
+    EXPECT_EQ(problem.fingerprint(), permuted.fingerprint());
+    EXPECT_NE(problem.fingerprint(), different.fingerprint());
+    EXPECT_NE(problem.fingerprint(), CNFProblem().fingerprint());
+}
+
+TEST (CNFProblemTestPatterns, sortReordersClausesInPlace) {
+    static_assert(std::is_same<decltype(std::declval<const CNFProblem&>()[0].begin()), const Lit*>::value, "clauses of a const problem are read-only");
+    CNFProblem problem { {Lit(0, 0), Lit(1, 0)}, {Lit(1, 0)}, {Lit(1, 0), Lit(2, 0)} };
+    problem.sort(false);
+    const CNFProblem& sorted = problem;
+    EXPECT_EQ(sorted[0][0], Lit(1, 0));
+    EXPECT_EQ(sorted[2][0], Lit(1, 0));
+    problem.sort(true);
+    EXPECT_EQ(sorted[0][0], Lit(0, 0));
+    EXPECT_EQ(sorted[2][0], Lit(2, 0));
+}
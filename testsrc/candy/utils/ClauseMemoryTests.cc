@@ -0,0 +1,247 @@
+#include <map>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "candy/core/SolverTypes.h"
+#include "candy/core/clauses/Clause.h"
+#include "candy/core/clauses/ClauseArena.h"
+#include "candy/core/clauses/ClauseAllocator.h"
+#include "candy/core/clauses/ClauseDatabase.h"
+
+using namespace Candy;
+
+TEST (ClauseArenaTestPatterns, referencesSpanSeveralArenas) {
+    const size_t page = 32 * 1024 * 1024;
+    std::vector<char*> pages;
+    for (int i = 0; i < 40; i++) { // more than one reservation
+        pages.push_back(static_cast<char*>(ClauseArena::acquire(page)));
+    }
+    for (char* memory : pages) {
+        for (size_t offset : { size_t(0), page / 2, page - 16 }) {
+            Clause* clause = reinterpret_cast<Clause*>(memory + offset);
+            EXPECT_EQ(ClauseArena::clause(ClauseArena::ref(clause)), clause);
+        }
+    }
+    memset(pages.back(), 1, 4096);
+    ClauseArena::release(pages.back(), page);
+    EXPECT_EQ(ClauseArena::acquire(page), pages.back());
+    for (char* memory : pages) {
+        ClauseArena::release(memory, page);
+    }
+}
+
+TEST (ClauseArenaTestPatterns, largePagesGetTheirOwnArena) {
+    const size_t size = (size_t(3) << 29) + 4096; // larger than a reservation
+    char* memory = static_cast<char*>(ClauseArena::acquire(size));
+    Clause* last = reinterpret_cast<Clause*>(memory + size - 16);
+    EXPECT_EQ(ClauseArena::clause(ClauseArena::ref(last)), last);
+    ClauseArena::release(memory, size);
+}
+
+static Clause* allocateClause(ClauseAllocator& allocator, std::vector<Lit> literals) {
+    return new (allocator.allocate(literals.size(), 3)) Clause(literals.begin(), literals.end(), 3);
+}
+
+TEST (ClauseAllocatorTestPatterns, releasedMemoryIsReusedAfterRecycle) {
+    ClauseAllocator allocator;
+    std::vector<Clause*> clauses;
+    for (unsigned int i = 0; i < 10; i++) {
+        clauses.push_back(allocateClause(allocator, std::vector<Lit>(3 + i, Lit(i, 0))));
+    }
+    Clause* three = clauses[0];
+    Clause* nine = clauses[6];
+    allocator.deallocate(three);
+    allocator.deallocate(nine);
+    EXPECT_NE(allocateClause(allocator, { Lit(1, 0), Lit(2, 0), Lit(3, 0) }), three); // might still be referenced
+    allocator.recycle();
+    EXPECT_EQ(allocateClause(allocator, { Lit(1, 0), Lit(2, 0), Lit(3, 0) }), three);
+    EXPECT_EQ(allocateClause(allocator, { Lit(4, 0), Lit(5, 0), Lit(6, 0), Lit(7, 0) }), nine); // split, the tail stays deleted
+    std::vector<Clause*> live = allocator.collect(); // pages are still iterable
+    ASSERT_EQ(live.size(), 11ul);
+    EXPECT_EQ(live[6], nine);
+    EXPECT_EQ(live[7], clauses[7]); // the clause after the tail is intact
+    EXPECT_EQ(live[7]->size(), 10u);
+}
+
+TEST (ClauseAllocatorTestPatterns, deletedClausesAreReusedAfterSweep) {
+    for (unsigned int pages : { 0, 1 }) {
+        ClauseDatabaseOptions::opt_reorganize_threshold = 100; // never defragment completely
+        CNFProblem problem { { Lit(0, 0), Lit(39, 0) }, { Lit(1, 1), Lit(2, 0), Lit(3, 0) } };
+        ClauseDatabase database(problem);
+        std::vector<const Clause*> deleted;
+        for (unsigned int i = 0; i < 30; i++) {
+            std::vector<Lit> literals { Lit(i, 0), Lit(i + 1, 0), Lit(i + 2, 0) };
+            Clause* clause = database.createClause(literals.begin(), literals.end(), 3);
+            if (i % 3 == 0) {
+                database.removeClause(clause);
+                deleted.push_back(clause);
+            }
+        }
+        if (pages == 0) {
+            database.reorganize();
+        }
+        else {
+            database.sweep();
+            const ClauseForwarding& forwarding = database.defragment(0); // nothing is evacuated
+            ASSERT_FALSE(forwarding.empty());
+            database.release_evacuated();
+        }
+        for (size_t i = 0; i < deleted.size(); i++) {
+            std::vector<Lit> literals { Lit(i, 1), Lit(i + 1, 1), Lit(i + 2, 1) };
+            const Clause* clause = database.createClause(literals.begin(), literals.end(), 3);
+            EXPECT_NE(std::find(deleted.begin(), deleted.end(), clause), deleted.end());
+        }
+        ClauseDatabaseOptions::opt_reorganize_threshold = 20;
+    }
+}
+
+static const size_t bytes10 = sizeof(Clause) + 9 * sizeof(Lit); // clause of length 10
+
+/* fills the given number of pages and starts the next one, the clauses by page */
+static std::vector<std::vector<Clause*>> fillPages(ClauseAllocatorMemory& memory, unsigned int filled) {
+    std::vector<std::vector<Clause*>> pages(1);
+    std::vector<Lit> literals(10, Lit(0, 0));
+    while (pages.size() <= filled || pages.back().size() < 10) {
+        Clause* clause = new (memory.allocate(literals.size())) Clause(literals.begin(), literals.end(), 3);
+        if (!pages.back().empty() && (char*)clause != (char*)pages.back().back() + bytes10) {
+            pages.emplace_back();
+        }
+        pages.back().push_back(clause);
+    }
+    return pages;
+}
+
+TEST (ClauseAllocatorTestPatterns, pageLookupAtPageBoundaries) {
+    ClauseAllocatorMemory memory(1);
+    std::vector<std::vector<Clause*>> pages = fillPages(memory, 4);
+    ASSERT_EQ(pages.size(), 5ul);
+    for (auto& page : pages) {
+        char* first = (char*)page.front();
+        char* end = (char*)page.back() + bytes10;
+        EXPECT_TRUE(memory.contains(page.front()));
+        EXPECT_TRUE(memory.contains(page.back()));
+        EXPECT_TRUE(memory.contains((Clause*)(end - 1)));
+        EXPECT_FALSE(memory.contains((Clause*)end)); // behind the last clause of the page
+        EXPECT_FALSE(memory.contains((Clause*)(first - 1))); // no page is filled up to its capacity
+    }
+    int before = 0;
+    EXPECT_FALSE(memory.contains((Clause*)&before));
+}
+
+TEST (ClauseAllocatorTestPatterns, mostFragmentedPagesAreEvacuated) {
+    ClauseAllocatorMemory memory(1);
+    std::vector<std::vector<Clause*>> pages = fillPages(memory, 5);
+    unsigned int percent[] = { 10, 60, 30, 25, 0, 90 }; // released per page, the last one is the current page
+    for (size_t i = 0; i < pages.size(); i++) {
+        for (size_t j = 0; j < pages[i].size() * percent[i] / 100; j++) {
+            memory.release(pages[i][j]);
+        }
+    }
+    ClauseForwarding forwarding;
+    memory.evacuate(2, 20, forwarding);
+    for (size_t i = 0; i < pages.size(); i++) {
+        bool selected = i == 1 || i == 2; // the two pages with most of more than 20 percent released, the current page is not evacuated
+        for (Clause* clause : { pages[i].front(), pages[i].back() }) {
+            EXPECT_EQ(memory.phase_out_contains(clause), selected);
+            EXPECT_EQ(forwarding.evacuated(ClauseArena::ref(clause)), selected);
+            EXPECT_NE(memory.contains(clause), selected);
+        }
+        uint32_t cref = ClauseArena::ref(pages[i].back());
+        ASSERT_TRUE(forwarding.relocate(cref));
+        EXPECT_EQ(ClauseArena::clause(cref) != pages[i].back(), selected);
+        EXPECT_TRUE(memory.contains(ClauseArena::clause(cref)));
+        EXPECT_EQ(ClauseArena::clause(cref)->size(), 10u);
+    }
+    memory.free_phase_out_pages();
+    EXPECT_FALSE(memory.phase_out_contains(pages[1].back()));
+}
+
+/**
+ * Learnt clauses over the variables of a small formula with varying lbds (at most the clause length), every third one is deleted 
+ * and every other one was used in a conflict
+ * */
+static std::map<std::vector<Lit>, std::pair<uint8_t, uint8_t>> learnMetadata(ClauseDatabase& database) {
+    std::map<std::vector<Lit>, std::pair<uint8_t, uint8_t>> expected; // lbd and usage counter (after decUsed) by literals
+    for (unsigned int i = 0; i < 30; i++) {
+        std::vector<Lit> literals { Lit(i, 0), Lit(i + 1, i % 2), Lit(i + 3, 1), Lit(35 + i % 5, 0) };
+        Clause* clause = database.createClause(literals.begin(), literals.end(), 2 + i % 3);
+        if (i % 3 == 0) {
+            database.removeClause(clause);
+            continue;
+        }
+        uint8_t lbd = clause->getLBD();
+        if (i % 2 == 0) {
+            lbd = 1 + i % 4;
+            database.metadata.update(clause, lbd);
+        }
+        expected[literals] = std::make_pair(lbd, i % 2 == 0 ? 2 : 1);
+    }
+    return expected;
+}
+
+static void checkMetadata(ClauseDatabase& database, std::map<std::vector<Lit>, std::pair<uint8_t, uint8_t>>& expected) {
+    size_t count = 0;
+    for (uint32_t id : database.metadata) {
+        ASSERT_FALSE(database.metadata.isDeleted(id));
+        Clause* clause = database.metadata.clause(id);
+        ASSERT_EQ(clause->id(), id);
+        std::vector<Lit> literals(clause->begin(), clause->end());
+        ASSERT_EQ(expected.count(literals), 1ul);
+        EXPECT_EQ(database.metadata.lbd(id), expected[literals].first);
+        EXPECT_EQ(clause->getLBD(), expected[literals].first);
+        EXPECT_EQ(database.metadata.decUsed(id), expected[literals].second);
+        count++;
+    }
+    EXPECT_EQ(count, expected.size());
+}
+
+TEST (ClauseMetadataTestPatterns, rebuildRenumbersLearntClauses) {
+    for (bool defragment : { true, false }) {
+        CNFProblem problem { { Lit(0, 0), Lit(39, 0) }, { Lit(1, 1), Lit(2, 0), Lit(3, 0) } };
+        ClauseDatabase database(problem);
+        auto expected = learnMetadata(database);
+        if (defragment) {
+            database.reorganize(); // clauses are moved
+        } else {
+            database.sweep();
+        }
+        checkMetadata(database, expected);
+        std::vector<uint32_t> ids(database.metadata.begin(), database.metadata.end());
+        std::sort(ids.begin(), ids.end());
+        for (size_t i = 0; i < ids.size(); i++) {
+            EXPECT_EQ(ids[i], i + 1); // dense
+        }
+        std::vector<Lit> literals { Lit(5, 0), Lit(6, 0), Lit(7, 0) };
+        EXPECT_EQ(database.createClause(literals.begin(), literals.end(), 3)->id(), ids.size() + 1); // the counter is rewound
+    }
+}
+
+TEST (ClauseMetadataTestPatterns, rebuildKeepsIdsOfLratProofs) {
+    SolverOptions::opt_certified_file = "clausememory.lrat";
+    SolverOptions::opt_certified_lrat = true;
+    {
+        CNFProblem problem { { Lit(0, 0), Lit(39, 0) }, { Lit(1, 1), Lit(2, 0), Lit(3, 0) } };
+        ClauseDatabase database(problem);
+        auto expected = learnMetadata(database);
+        std::map<std::vector<Lit>, uint32_t> ids;
+        for (uint32_t id : database.metadata) {
+            Clause* clause = database.metadata.clause(id);
+            ids[std::vector<Lit>(clause->begin(), clause->end())] = id;
+        }
+        database.reorganize();
+        checkMetadata(database, expected);
+        for (uint32_t id : database.metadata) {
+            Clause* clause = database.metadata.clause(id);
+            EXPECT_EQ(ids[std::vector<Lit>(clause->begin(), clause->end())], id);
+        }
+        std::vector<Lit> literals { Lit(5, 0), Lit(6, 0), Lit(7, 0) };
+        EXPECT_EQ(database.createClause(literals.begin(), literals.end(), 3)->id(), 2u + 30u + 1u); // not rewound
+    }
+    SolverOptions::opt_certified_file = "";
+    SolverOptions::opt_certified_lrat = false;
+    std::remove("clausememory.lrat");
+}
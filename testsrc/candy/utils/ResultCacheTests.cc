@@ -0,0 +1,42 @@
+#include <cstdio>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "candy/core/SolverTypes.h"
+#include "candy/utils/ResultCache.h"
+
+using namespace Candy;
+
+TEST (ResultCacheTestPatterns, storeAndLookup) {
+    ResultCache cache(".");
+    std::vector<Lit> model { Lit(0, 0), Lit(1, 1), Lit(2, 0) };
+    std::vector<Lit> cached;
+    std::string proof;
+
+    EXPECT_EQ(cache.lookup(1, cached, proof), l_Undef);
+
+    ASSERT_TRUE(cache.store(1, l_True, model, ""));
+    EXPECT_EQ(cache.lookup(1, cached, proof), l_True);
+    EXPECT_EQ(cached, model);
+    EXPECT_TRUE(proof.empty());
+
+    ASSERT_TRUE(cache.store(2, l_False, {}, "proofs/instance.drat"));
+    EXPECT_EQ(cache.lookup(2, cached, proof), l_False);
+    EXPECT_TRUE(cached.empty());
+    EXPECT_EQ(proof, "proofs/instance.drat");
+
+    std::remove(cache.filename(1).c_str());
+    std::remove(cache.filename(2).c_str());
+}
+
+TEST (ResultCacheTestPatterns, truncatedModelIsIgnored) {
+    ResultCache cache(".");
+    std::ofstream out(cache.filename(3));
+    out << "s SATISFIABLE\nv 1 -2";
+    out.close();
+    std::vector<Lit> cached;
+    std::string proof;
+    EXPECT_EQ(cache.lookup(3, cached, proof), l_Undef);
+    std::remove(cache.filename(3).c_str());
+}
@@ -0,0 +1,50 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "candy/core/SolverTypes.h"
+#include "candy/core/CandySolverResult.h"
+#include "candy/utils/ResultWriter.h"
+
+using namespace Candy;
+
+TEST (ResultWriterTestPatterns, modelLinesAreBounded) {
+    const char* filename = "resultwriter_model.txt";
+    CandySolverResult model;
+    for (Var v = 0; v < 100000; v++) {
+        if (v != 5) model.setModelValue(Lit(v, v % 3 == 0));
+    }
+    {
+        ResultWriter writer(filename);
+        ASSERT_TRUE(writer.isOpen());
+        writer.writeStatus(l_True);
+        writer.writeModel(model, 100000);
+        ASSERT_TRUE(writer.flush());
+    }
+    std::ifstream in(filename);
+    std::string line;
+    std::getline(in, line);
+    EXPECT_EQ(line, "s SATISFIABLE");
+    int expected = 1;
+    bool terminated = false;
+    while (std::getline(in, line)) {
+        ASSERT_LE(line.size(), 78ul);
+        ASSERT_EQ(line[0], 'v');
+        std::istringstream tokens(line.substr(1));
+        for (int lit; tokens >> lit; ) {
+            if (lit == 0) {
+                terminated = true;
+                break;
+            }
+            if (expected == 6) expected++; // variable without value is omitted
+            ASSERT_EQ(lit, (expected - 1) % 3 == 0 ? -expected : expected);
+            expected++;
+        }
+    }
+    std::remove(filename);
+    EXPECT_TRUE(terminated);
+    EXPECT_EQ(expected, 100001);
+}